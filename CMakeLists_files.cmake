@@ -82,6 +82,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/blackoil/blackoilboundaryratevector.hh
              opm/models/common/multiphasebaseproperties.hh
              opm/models/common/multiphasebasemodel.hh
+             opm/models/common/thermodynamichintstore.hh
              opm/models/common/quantitycallbacks.hh
              opm/models/common/multiphasebaseextensivequantities.hh
              opm/models/common/multiphasebaseproblem.hh
@@ -104,6 +105,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/discretization/vcfv/vcfvgridcommhandlefactory.hh
              opm/models/discretization/vcfv/vcfvproperties.hh
              opm/models/discretization/vcfv/vcfvstencil.hh
+             opm/models/discretization/vcfv/vcfvstencilgeometry.hh
              opm/models/discretization/common/fvbasenewtonmethod.hh
              opm/models/discretization/common/fvbasenewtonconvergencewriter.hh
              opm/models/discretization/common/fvbaseintensivequantities.hh
@@ -126,6 +128,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/discretization/common/linearizationtype.hh
              opm/models/discretization/ecfv/ecfvgridcommhandlefactory.hh
              opm/models/discretization/ecfv/ecfvstencil.hh
+             opm/models/discretization/ecfv/ecfvstencilgeometry.hh
              opm/models/discretization/ecfv/ecfvbaseoutputmodule.hh
              opm/models/discretization/ecfv/ecfvdiscretization.hh
              opm/models/discretization/ecfv/ecfvproperties.hh
@@ -151,6 +154,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/io/dgfvanguard.hh
              opm/models/io/vtkscalarfunction.hh
              opm/models/io/vtkenergymodule.hh
+             opm/models/io/binaryrestart.hh
              opm/models/io/restart.hh
              opm/models/io/cubegridvanguard.hh
              opm/models/io/baseoutputwriter.hh
@@ -215,6 +219,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/models/utils/propertysystemmacros.hh
              opm/models/utils/pffgridvector.hh
              opm/models/utils/prefetch.hh
+             opm/models/utils/profiler.hh
              opm/models/utils/parametersystem.hh
              opm/models/utils/simulator.hh
              opm/models/utils/quadraturegeometries.hh
@@ -243,6 +248,7 @@ list (APPEND PUBLIC_HEADER_FILES
              opm/simulators/linalg/bicgstabsolver.hh
              opm/simulators/linalg/globalindices.hh
              opm/simulators/linalg/superlubackend.hh
+             opm/simulators/linalg/sparsitypattern.hh
              opm/simulators/linalg/matrixblock.hh
              opm/simulators/linalg/istlsolverwrappers.hh
              opm/simulators/linalg/overlaptypes.hh
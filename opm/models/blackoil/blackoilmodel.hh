@@ -455,8 +455,11 @@ public:
 
         // write the primary variables
         const auto& priVars = this->solution(/*timeIdx=*/0)[dofIdx];
-        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
-            outstream << priVars[eqIdx] << " ";
+        if (BinaryRestart::isBinary(outstream))
+            outstream.write(reinterpret_cast<const char*>(&priVars[0]), numEq*sizeof(priVars[0]));
+        else
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                outstream << priVars[eqIdx] << " ";
 
         // write the pseudo primary variables
         outstream << priVars.primaryVarsMeaning() << " ";
@@ -483,10 +486,16 @@ public:
 
         // read in the "real" primary variables of the DOF
         auto& priVars = this->solution(/*timeIdx=*/0)[dofIdx];
-        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
-            if (!instream.good())
+        if (BinaryRestart::isBinary(instream)) {
+            if (!instream.read(reinterpret_cast<char*>(&priVars[0]), numEq*sizeof(priVars[0])))
                 throw std::runtime_error("Could not deserialize degree of freedom "+std::to_string(dofIdx));
-            instream >> priVars[eqIdx];
+        }
+        else {
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                if (!instream.good())
+                    throw std::runtime_error("Could not deserialize degree of freedom "+std::to_string(dofIdx));
+                instream >> priVars[eqIdx];
+            }
         }
 
         // read the pseudo primary variables
@@ -49,6 +49,7 @@
 
 #include <dune/common/fvector.hh>
 
+#include <algorithm>
 #include <string>
 
 namespace Opm {
@@ -854,39 +855,25 @@ public:
         // where M(v) is computed from user input
         // and P = viscosityMultiplier
         const std::vector<Scalar>& shearEffectRefMultiplier = plyshlogShearEffectRefMultiplier_[pvtnumRegionIdx];
-        size_t numTableEntries = shearEffectRefLogVelocity.size();
-        assert(shearEffectRefMultiplier.size() == numTableEntries);
-
-        std::vector<Scalar> shearEffectMultiplier(numTableEntries, 1.0);
-        for (size_t i = 0; i < numTableEntries; ++i) {
-            shearEffectMultiplier[i] = (1.0 + (viscosityMultiplier - 1.0)*shearEffectRefMultiplier[i]) / viscosityMultiplier;
-            shearEffectMultiplier[i] = Opm::log(shearEffectMultiplier[i]);
-        }
-        // store the logarithmic velocity and logarithmic multipliers in a table for easy look up and
-        // linear interpolation in the logarithmic space.
-        TabulatedFunction logShearEffectMultiplier = TabulatedFunction(numTableEntries, shearEffectRefLogVelocity, shearEffectMultiplier, /*bool sortInputs =*/ false);
+        assert(shearEffectRefMultiplier.size() == shearEffectRefLogVelocity.size());
 
         // Find sheared velocity (v) that satisfies
         // F = log(v) + log (Z) - log(v0) = 0;
-
-        // Set up the function
-        // u = log(v)
-        auto F = [&logShearEffectMultiplier, &v0AbsLog](const Evaluation& u) {
-            return u + logShearEffectMultiplier.eval(u, true) - v0AbsLog;
-        };
-        // and its derivative
-        auto dF = [&logShearEffectMultiplier](const Evaluation& u) {
-            return 1 + logShearEffectMultiplier.evalDerivative(u, true);
-        };
+        // where log(Z) is interpolated linearly in the logarithmic velocity space.
 
         // Solve F = 0 using Newton
-        // Use log(v0) as initial value for u
+        // Use log(v0) as initial value for u = log(v)
         auto u = v0AbsLog;
+        Scalar slope;
         bool converged = false;
         // TODO make this into parameters
         for (int i = 0; i < 20; ++i) {
-            auto f = F(u);
-            auto df = dF(u);
+            auto f = u + evalLogShearEffectMultiplier_(u,
+                                                       shearEffectRefLogVelocity,
+                                                       shearEffectRefMultiplier,
+                                                       viscosityMultiplier,
+                                                       slope) - v0AbsLog;
+            Scalar df = 1 + slope;
             u -= f/df;
             if (std::abs(Opm::scalarValue(f)) < 1e-12) {
                 converged = true;
@@ -898,7 +885,11 @@ public:
         }
 
         // return the shear factor
-        return Opm::exp(logShearEffectMultiplier.eval(u, /*extrapolate=*/true));
+        return Opm::exp(evalLogShearEffectMultiplier_(u,
+                                                      shearEffectRefLogVelocity,
+                                                      shearEffectRefMultiplier,
+                                                      viscosityMultiplier,
+                                                      slope));
 
     }
 
@@ -908,6 +899,52 @@ public:
     }
 
 private:
+    // Evaluate the logarithm of the shear effect multiplier log(Z) for a logarithmic
+    // velocity u by linear interpolation of the PLYSHLOG table, extrapolating linearly
+    // outside of it. The derivative w.r.t. u is returned in the 'slope' argument.
+    //
+    // The values at the two sampling points of the relevant segment are computed on
+    // the fly from the viscosity multiplier P as log((1 + (P - 1)*M)/P), i.e., no
+    // table needs to be allocated for the current polymer concentration.
+    template <class Evaluation>
+    static Evaluation evalLogShearEffectMultiplier_(const Evaluation& u,
+                                                    const std::vector<Scalar>& refLogVelocity,
+                                                    const std::vector<Scalar>& refMultiplier,
+                                                    Scalar viscosityMultiplier,
+                                                    Scalar& slope)
+    {
+        size_t numTableEntries = refLogVelocity.size();
+        auto logZ = [&refMultiplier, viscosityMultiplier](size_t i) {
+            return std::log((1.0 + (viscosityMultiplier - 1.0)*refMultiplier[i]) / viscosityMultiplier);
+        };
+
+        if (numTableEntries < 2) {
+            slope = 0.0;
+            return logZ(0);
+        }
+
+        // find the segment in the same way as Tabulated1DFunction
+        Scalar uValue = Opm::scalarValue(u);
+        size_t segIdx;
+        if (uValue <= refLogVelocity[1])
+            segIdx = 0;
+        else if (uValue >= refLogVelocity[numTableEntries - 2])
+            segIdx = numTableEntries - 2;
+        else
+            segIdx = static_cast<size_t>(std::lower_bound(refLogVelocity.begin() + 1,
+                                                          refLogVelocity.end() - 1,
+                                                          uValue)
+                                         - refLogVelocity.begin()) - 1;
+
+        Scalar x0 = refLogVelocity[segIdx];
+        Scalar x1 = refLogVelocity[segIdx + 1];
+        Scalar y0 = logZ(segIdx);
+        Scalar y1 = logZ(segIdx + 1);
+
+        slope = (y1 - y0)/(x1 - x0);
+        return y0 + slope*(u - x0);
+    }
+
     static std::vector<Scalar> plyrockDeadPoreVolume_;
     static std::vector<Scalar> plyrockResidualResistanceFactor_;
     static std::vector<Scalar> plyrockRockDensityFactor_;
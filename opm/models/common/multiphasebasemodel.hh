@@ -33,6 +33,7 @@
 #include "multiphasebaseproperties.hh"
 #include "multiphasebaseproblem.hh"
 #include "multiphasebaseextensivequantities.hh"
+#include "thermodynamichintstore.hh"
 
 #include <opm/models/common/flux.hh>
 #include <opm/models/discretization/vcfv/vcfvdiscretization.hh>
@@ -45,6 +46,11 @@
 #include <opm/material/thermal/NullSolidEnergyLaw.hpp>
 #include <opm/material/common/Unused.hpp>
 
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+
 namespace Opm {
 template <class TypeTag>
 class MultiPhaseBaseModel;
@@ -169,9 +175,15 @@ class MultiPhaseBaseModel : public GetPropType<TypeTag, Properties::Discretizati
     enum { numPhases = getPropValue<TypeTag, Properties::NumPhases>() };
     enum { numComponents = FluidSystem::numComponents };
 
+    using HintStore = ThermodynamicHintStore<Scalar, numPhases, numComponents>;
+
 public:
+    //! The type of the objects returned by thermodynamicHint()
+    using ThermodynamicHint = typename HintStore::Hint;
+
     MultiPhaseBaseModel(Simulator& simulator)
         : ParentType(simulator)
+        , thermodynamicHintSequenceNumber_(-1)
     { }
 
     /*!
@@ -186,6 +198,42 @@ public:
         Opm::VtkTemperatureModule<TypeTag>::registerParameters();
     }
 
+    /*!
+     * \brief Return the thermodynamic hint for a degree of freedom.
+     *
+     * The hint consists of the pressures, saturations and phase compositions of the
+     * last solution for which the non-linear solver converged. It is intended as the
+     * starting point of non-linear solvers which need to be run when updating the
+     * intensive quantities, e.g., flash calculations.
+     *
+     * \attention If hints are disabled or if no hint is available for the degree of
+     *            freedom, the returned object evaluates to false.
+     *
+     * \param globalIdx The global space index for the entity where a hint is requested.
+     * \param timeIdx The index used by the time discretization.
+     */
+    ThermodynamicHint thermodynamicHint(unsigned globalIdx, unsigned timeIdx OPM_UNUSED) const
+    {
+        if (!this->enableThermodynamicHints()
+            || thermodynamicHintSequenceNumber_ != this->simulator_.vanguard().gridSequenceNumber())
+            return ThermodynamicHint();
+
+        return thermodynamicHints_.hint(globalIdx);
+    }
+
+    /*!
+     * \brief Called by the update() method if it was successful.
+     *
+     * If thermodynamic hints are enabled, they are updated using the new solution.
+     */
+    void updateSuccessful()
+    {
+        ParentType::updateSuccessful();
+
+        if (this->enableThermodynamicHints())
+            updateThermodynamicHints_();
+    }
+
     /*!
      * \brief Returns true iff a fluid phase is used by the model.
      *
@@ -207,7 +255,7 @@ public:
 
         storage = 0;
 
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(this->gridView());
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(this->gridView(), this->elementChunks());
         std::mutex mutex;
 #ifdef _OPENMP
 #pragma omp parallel
@@ -264,6 +312,69 @@ public:
 private:
     const Implementation& asImp_() const
     { return *static_cast<const Implementation *>(this); }
+
+    // store the thermodynamic state of each degree of freedom for the current solution.
+    // each degree of freedom is only evaluated once by the element which owns it. if
+    // the intensive quantities are cached, they are used without re-evaluating them.
+    void updateThermodynamicHints_()
+    {
+        this->updateDofOwners_();
+
+        size_t numDof = this->dofOwnerLocalIdx_.size();
+        int seqNum = this->simulator_.vanguard().gridSequenceNumber();
+        if (thermodynamicHintSequenceNumber_ != seqNum || thermodynamicHints_.size() != numDof) {
+            thermodynamicHints_.resize(numDof);
+            thermodynamicHintSequenceNumber_ = seqNum;
+        }
+
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> failed(false);
+        const auto& grid = this->gridView_.grid();
+        const long numDofLong = static_cast<long>(numDof);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(this->simulator_);
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (long i = 0; i < numDofLong; ++i) {
+                if (failed.load(std::memory_order_relaxed))
+                    continue;
+
+                unsigned globalIdx = static_cast<unsigned>(i);
+                unsigned localIdx = this->dofOwnerLocalIdx_[globalIdx];
+                if (localIdx == std::numeric_limits<unsigned short>::max())
+                    continue; // not a primary degree of freedom of any element
+
+                try {
+                    const auto* intQuants = this->cachedIntensiveQuantities(globalIdx, /*timeIdx=*/0);
+                    if (!intQuants) {
+                        Element elem = grid.entity(this->dofOwnerSeed_[globalIdx]);
+                        elemCtx.updatePrimaryStencil(elem);
+                        elemCtx.updateIntensiveQuantitiesOfDof(localIdx, /*timeIdx=*/0);
+                        intQuants = &elemCtx.intensiveQuantities(localIdx, /*timeIdx=*/0);
+                    }
+
+                    thermodynamicHints_.store(globalIdx, intQuants->fluidState());
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> take(exceptionLock);
+                    exceptionPtr = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+
+    HintStore thermodynamicHints_;
+    int thermodynamicHintSequenceNumber_;
 };
 } // namespace Opm
 
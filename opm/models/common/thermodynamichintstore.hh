@@ -0,0 +1,190 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::ThermodynamicHintStore
+ */
+#ifndef EWOMS_THERMODYNAMIC_HINT_STORE_HH
+#define EWOMS_THERMODYNAMIC_HINT_STORE_HH
+
+#include <opm/material/densead/Math.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup MultiPhaseBaseModel
+ *
+ * \brief Stores the parts of the thermodynamic state of each degree of freedom which
+ *        are needed as the starting point of the non-linear solvers used to update the
+ *        intensive quantities.
+ *
+ * In contrast to an intensive quantities object, only the scalar values of the phase
+ * pressures, the saturations and the phase compositions are stored. Each of these
+ * quantities is kept in a separate array which is indexed by the degree of freedom.
+ */
+template <class Scalar, unsigned numPhases, unsigned numComponents>
+class ThermodynamicHintStore
+{
+    enum { numFields = 2*numPhases + numPhases*numComponents };
+
+public:
+    /*!
+     * \brief The thermodynamic hint of a single degree of freedom.
+     *
+     * A default constructed object does not point to any data and evaluates to false.
+     */
+    class Hint
+    {
+    public:
+        Hint()
+            : store_(nullptr)
+            , dofIdx_(0)
+        { }
+
+        Hint(const ThermodynamicHintStore& store, unsigned dofIdx)
+            : store_(&store)
+            , dofIdx_(dofIdx)
+        { }
+
+        explicit operator bool() const
+        { return store_ != nullptr; }
+
+        Scalar pressure(unsigned phaseIdx) const
+        { return store_->fields_[pressureField_(phaseIdx)][dofIdx_]; }
+
+        Scalar saturation(unsigned phaseIdx) const
+        { return store_->fields_[saturationField_(phaseIdx)][dofIdx_]; }
+
+        Scalar moleFraction(unsigned phaseIdx, unsigned compIdx) const
+        { return store_->fields_[moleFractionField_(phaseIdx, compIdx)][dofIdx_]; }
+
+        /*!
+         * \brief The ratio of the mole fraction of a component in a phase and its mole
+         *        fraction in the first phase.
+         */
+        Scalar kValue(unsigned phaseIdx, unsigned compIdx) const
+        { return moleFraction(phaseIdx, compIdx)/moleFraction(/*phaseIdx=*/0, compIdx); }
+
+        bool phaseIsPresent(unsigned phaseIdx) const
+        { return saturation(phaseIdx) > 0.0; }
+
+        /*!
+         * \brief Set the pressures, saturations and phase compositions of a fluid state
+         *        to the ones of the hint.
+         *
+         * The temperature of the fluid state is left alone.
+         */
+        template <class FluidState>
+        void assignTo(FluidState& fluidState) const
+        {
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                fluidState.setPressure(phaseIdx, pressure(phaseIdx));
+                fluidState.setSaturation(phaseIdx, saturation(phaseIdx));
+                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                    fluidState.setMoleFraction(phaseIdx, compIdx, moleFraction(phaseIdx, compIdx));
+            }
+        }
+
+    private:
+        const ThermodynamicHintStore* store_;
+        unsigned dofIdx_;
+    };
+
+    /*!
+     * \brief Allocate the storage for a given number of degrees of freedom.
+     *
+     * All hints are invalid afterwards.
+     */
+    void resize(size_t numDof)
+    {
+        for (auto& field : fields_)
+            field.resize(numDof);
+        isValid_.assign(numDof, 0);
+    }
+
+    /*!
+     * \brief Returns the number of degrees of freedom for which storage is allocated.
+     */
+    size_t size() const
+    { return isValid_.size(); }
+
+    /*!
+     * \brief Returns the hint for a degree of freedom.
+     *
+     * If no valid hint is available, the returned object evaluates to false.
+     */
+    Hint hint(unsigned dofIdx) const
+    {
+        if (dofIdx >= isValid_.size() || !isValid_[dofIdx])
+            return Hint();
+
+        return Hint(*this, dofIdx);
+    }
+
+    /*!
+     * \brief Set the hint of a degree of freedom from a fluid state.
+     *
+     * Concurrently storing the hints of different degrees of freedom is safe.
+     */
+    template <class FluidState>
+    void store(unsigned dofIdx, const FluidState& fluidState)
+    {
+        assert(dofIdx < isValid_.size());
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fields_[pressureField_(phaseIdx)][dofIdx] =
+                Opm::getValue(fluidState.pressure(phaseIdx));
+            fields_[saturationField_(phaseIdx)][dofIdx] =
+                Opm::getValue(fluidState.saturation(phaseIdx));
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fields_[moleFractionField_(phaseIdx, compIdx)][dofIdx] =
+                    Opm::getValue(fluidState.moleFraction(phaseIdx, compIdx));
+        }
+
+        isValid_[dofIdx] = 1;
+    }
+
+private:
+    static unsigned pressureField_(unsigned phaseIdx)
+    { return phaseIdx; }
+
+    static unsigned saturationField_(unsigned phaseIdx)
+    { return numPhases + phaseIdx; }
+
+    static unsigned moleFractionField_(unsigned phaseIdx, unsigned compIdx)
+    { return 2*numPhases + phaseIdx*numComponents + compIdx; }
+
+    std::array<std::vector<Scalar>, numFields> fields_;
+    // this is not a std::vector<bool> because its bits cannot be written concurrently
+    std::vector<unsigned char> isValid_;
+};
+
+} // namespace Opm
+
+#endif
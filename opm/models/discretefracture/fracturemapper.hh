@@ -30,34 +30,32 @@
 #include <opm/models/utils/propertysystem.hh>
 
 #include <algorithm>
-#include <set>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
 
 namespace Opm {
 
 /*!
  * \ingroup DiscreteFractureModel
  * \brief Stores the topology of fractures.
+ *
+ * Since the fracture network is queried for every degree of freedom and every
+ * sub-control volume face in each iteration, it is stored in flat arrays indexed by
+ * the vertex index: A flag which specifies whether a vertex is part of a fracture and,
+ * in compressed sparse row format, the sorted indices of the vertices with a larger
+ * index to which each vertex is connected by a fracture edge. Querying a vertex is
+ * thus O(1), querying an edge is a binary search over the few fracture edges of one
+ * of its vertices.
+ *
+ * The compressed structure is created by finalize(), which must be called after the
+ * last fracture edge has been added. If more edges are added later, finalize() must be
+ * called again before the next query.
  */
 template <class TypeTag>
 class FractureMapper
 {
-    struct FractureEdge
-    {
-        FractureEdge(unsigned edgeVertex1Idx, unsigned edgeVertex2Idx)
-            : i_(std::min(edgeVertex1Idx, edgeVertex2Idx)),
-              j_(std::max(edgeVertex1Idx, edgeVertex2Idx))
-        {}
-
-        bool operator<(const FractureEdge& e) const
-        { return i_ < e.i_ || (i_ == e.i_ && j_ < e.j_); }
-
-        bool operator==(const FractureEdge& e) const
-        { return i_ == e.i_ && j_ == e.j_; }
-
-        unsigned i_;
-        unsigned j_;
-    };
-
 public:
     /*!
      * \brief Constructor
@@ -73,9 +71,53 @@ public:
      */
     void addFractureEdge(unsigned vertexIdx1, unsigned vertexIdx2)
     {
-        fractureEdges_.insert(FractureEdge(vertexIdx1, vertexIdx2));
-        fractureVertices_.insert(vertexIdx1);
-        fractureVertices_.insert(vertexIdx2);
+        unsigned i = std::min(vertexIdx1, vertexIdx2);
+        unsigned j = std::max(vertexIdx1, vertexIdx2);
+
+        if (fractureVertices_.size() <= j)
+            fractureVertices_.resize(j + 1, /*value=*/false);
+
+        fractureVertices_[i] = true;
+        fractureVertices_[j] = true;
+
+        pendingEdges_.emplace_back(i, j);
+    }
+
+    /*!
+     * \brief Create the compressed representation of the fracture edges.
+     *
+     * This must be called after all fracture edges have been added and before the
+     * fracture network is queried. The edges which were compressed by a previous call
+     * are kept.
+     */
+    void finalize()
+    {
+        // merge the edges of a previous call with the ones added since then
+        for (size_t vertexIdx = 0; vertexIdx + 1 < neighborOffsets_.size(); ++vertexIdx)
+            for (size_t edgeIdx = neighborOffsets_[vertexIdx];
+                 edgeIdx < neighborOffsets_[vertexIdx + 1];
+                 ++edgeIdx)
+                pendingEdges_.emplace_back(static_cast<unsigned>(vertexIdx), neighbors_[edgeIdx]);
+
+        // sort the edges by their first and then by their second vertex and remove the
+        // duplicates. the second vertices of each first vertex are then consecutive.
+        std::sort(pendingEdges_.begin(), pendingEdges_.end());
+        pendingEdges_.erase(std::unique(pendingEdges_.begin(), pendingEdges_.end()),
+                            pendingEdges_.end());
+
+        size_t numVertices = fractureVertices_.size();
+        neighborOffsets_.assign(numVertices + 1, 0);
+        for (const auto& edge : pendingEdges_)
+            ++ neighborOffsets_[edge.first + 1];
+        for (size_t vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+            neighborOffsets_[vertexIdx + 1] += neighborOffsets_[vertexIdx];
+
+        neighbors_.resize(pendingEdges_.size());
+        for (size_t edgeIdx = 0; edgeIdx < pendingEdges_.size(); ++edgeIdx)
+            neighbors_[edgeIdx] = pendingEdges_[edgeIdx].second;
+
+        pendingEdges_.clear();
+        pendingEdges_.shrink_to_fit();
     }
 
     /*!
@@ -84,7 +126,7 @@ public:
      * \param vertexIdx The index of the vertex.
      */
     bool isFractureVertex(unsigned vertexIdx) const
-    { return fractureVertices_.count(vertexIdx) > 0; }
+    { return vertexIdx < fractureVertices_.size() && fractureVertices_[vertexIdx]; }
 
     /*!
      * \brief Returns true iff a fracture is associated with a given edge.
@@ -94,13 +136,33 @@ public:
      */
     bool isFractureEdge(unsigned vertex1Idx, unsigned vertex2Idx) const
     {
-        FractureEdge tmp(vertex1Idx, vertex2Idx);
-        return fractureEdges_.count(tmp) > 0;
+        assert(pendingEdges_.empty()); // finalize() has not been called
+
+        unsigned i = std::min(vertex1Idx, vertex2Idx);
+        unsigned j = std::max(vertex1Idx, vertex2Idx);
+
+        // most edges are rejected by this
+        if (!isFractureVertex(i) || !isFractureVertex(j))
+            return false;
+
+        // the vertex is not yet known to the compressed edges
+        if (i + 1 >= neighborOffsets_.size())
+            return false;
+
+        auto beginIt = neighbors_.begin() + static_cast<std::ptrdiff_t>(neighborOffsets_[i]);
+        auto endIt = neighbors_.begin() + static_cast<std::ptrdiff_t>(neighborOffsets_[i + 1]);
+        return std::binary_search(beginIt, endIt, j);
     }
 
 private:
-    std::set<FractureEdge> fractureEdges_;
-    std::set<unsigned> fractureVertices_;
+    std::vector<unsigned char> fractureVertices_;
+
+    // the fracture edges in compressed sparse row format
+    std::vector<size_t> neighborOffsets_;
+    std::vector<unsigned> neighbors_;
+
+    // the edges added since the last call to finalize()
+    std::vector<std::pair<unsigned, unsigned> > pendingEdges_;
 };
 
 } // namespace Opm
@@ -31,7 +31,8 @@
 
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 
-#include <set>
+#include <opm/simulators/linalg/sparsitypattern.hh>
+
 #include <vector>
 
 namespace Opm::Properties::Tag {
@@ -59,7 +60,7 @@ class BaseAuxiliaryModule
     using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
 
 protected:
-    using NeighborSet = std::set<unsigned>;
+    using SparsityPattern = Opm::Linear::SparsityPattern;
 
 public:
     virtual ~BaseAuxiliaryModule()
@@ -99,8 +100,12 @@ public:
     /*!
      * \brief Specify the additional neighboring correlations caused by the auxiliary
      *        module.
+     *
+     * The entries are added via SparsityPattern::add(). Note that this method is called
+     * twice while the sparsity pattern is built, once for counting the entries and once
+     * for storing them, so it must add the same entries both times.
      */
-    virtual void addNeighbors(std::vector<NeighborSet>& neighbors) const = 0;
+    virtual void addNeighbors(SparsityPattern& neighbors) const = 0;
 
     /*!
      * \brief Set the initial condition of the auxiliary module in the solution vector.
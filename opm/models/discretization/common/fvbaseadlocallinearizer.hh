@@ -199,6 +199,39 @@ public:
         }
     }
 
+    /*!
+     * \brief Only evaluate an element's residual and leave its local Jacobian matrix
+     *        alone.
+     *
+     * Since the value of the residual does not depend on the focus degree of freedom,
+     * the local residual only needs to be evaluated once for the whole element instead
+     * of once for each of its primary degrees of freedom.
+     *
+     * \param elemCtx The element execution context for which the local residual should
+     *                be calculated.
+     */
+    void linearizeResidual(ElementContext& elemCtx, const Element& elem)
+    {
+        elemCtx.updateStencil(elem);
+        elemCtx.updateAllIntensiveQuantities();
+
+        // update the weights of the primary variables for the context
+        model_().updatePVWeights(elemCtx);
+
+        resize_(elemCtx);
+        reset_(elemCtx);
+
+        elemCtx.setFocusDofIndex(/*dofIdx=*/0);
+        elemCtx.updateAllExtensiveQuantities();
+        localResidual_.eval(elemCtx);
+
+        const auto& resid = localResidual_.residual();
+        unsigned numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+        for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; dofIdx++)
+            for (unsigned eqIdx = 0; eqIdx < numEq; eqIdx++)
+                residual_[dofIdx][eqIdx] = resid[dofIdx][eqIdx].value();
+    }
+
     /*!
      * \brief Return reference to the local residual.
      */
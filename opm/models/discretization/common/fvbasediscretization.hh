@@ -49,12 +49,14 @@
 
 #include <opm/models/parallel/gridcommhandles.hh>
 #include <opm/models/parallel/threadmanager.hh>
+#include <opm/models/parallel/threadedentityiterator.hh>
 #include <opm/simulators/linalg/nullborderlistmanager.hh>
 #include <opm/models/utils/simulator.hh>
 #include <opm/models/utils/alignedallocator.hh>
 #include <opm/models/utils/timer.hh>
 #include <opm/models/utils/timerguard.hh>
 #include <opm/models/io/vtkprimaryvarsmodule.hh>
+#include <opm/models/io/binaryrestart.hh>
 #include <opm/simulators/linalg/matrixblock.hh>
 
 #include <opm/material/common/MathToolbox.hpp>
@@ -74,9 +76,14 @@
 #include <dune/fem/misc/capabilities.hh>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <limits>
 #include <list>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -219,8 +226,15 @@ struct ThreadManager<TypeTag, TTag::FvBaseDiscretization> { using type = Opm::Th
 template<class TypeTag>
 struct ThreadsPerProcess<TypeTag, TTag::FvBaseDiscretization> { static constexpr int value = 1; };
 template<class TypeTag>
+struct ThreadChunkSize<TypeTag, TTag::FvBaseDiscretization> { static constexpr unsigned value = 32; };
+template<class TypeTag>
 struct UseLinearizationLock<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = true; };
 
+//! use the global lock instead of element coloring for multi-threaded linearization by
+//! default
+template<class TypeTag>
+struct EnableColoredLinearization<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
 /*!
  * \brief Linearizer for the global system of equations.
  */
@@ -280,8 +294,19 @@ struct EnableConstraints<TypeTag, TTag::FvBaseDiscretization> { static constexpr
 template<class TypeTag>
 struct EnableIntensiveQuantityCache<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
 
-// do not use thermodynamic hints by default. If you enable this, make sure to also
-// enable the intensive quantity cache above to avoid getting an exception...
+// by default, the intensive quantities are computed lazily by the element contexts
+template<class TypeTag>
+struct EnableIntensiveQuantityPrepass<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
+// by default, the intensive quantities of the whole history are cached
+template<class TypeTag>
+struct EnableLeanIntensiveQuantityCache<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
+// by default, the stencils query their geometry from the grid
+template<class TypeTag>
+struct EnableStencilGeometryCache<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
+
+// do not use thermodynamic hints by default
 template<class TypeTag>
 struct EnableThermodynamicHints<TypeTag, TTag::FvBaseDiscretization> { static constexpr bool value = false; };
 
@@ -357,6 +382,7 @@ class FvBaseDiscretization
     using ExtensiveQuantities = GetPropType<TypeTag, Properties::ExtensiveQuantities>;
     using GradientCalculator = GetPropType<TypeTag, Properties::GradientCalculator>;
     using Stencil = GetPropType<TypeTag, Properties::Stencil>;
+    using StencilGeometry = typename Stencil::StencilGeometry;
     using DiscBaseOutputModule = GetPropType<TypeTag, Properties::DiscBaseOutputModule>;
     using GridCommHandleFactory = GetPropType<TypeTag, Properties::GridCommHandleFactory>;
     using NewtonMethod = GetPropType<TypeTag, Properties::NewtonMethod>;
@@ -374,6 +400,7 @@ class FvBaseDiscretization
 
     using Element = typename GridView::template Codim<0>::Entity;
     using ElementIterator = typename GridView::template Codim<0>::Iterator;
+    using ElementSeed = typename Element::EntitySeed;
 
     using Toolbox = Opm::MathToolbox<Evaluation>;
     using VectorBlock = Dune::FieldVector<Evaluation, numEq>;
@@ -381,6 +408,8 @@ class FvBaseDiscretization
 
     using LocalEvalBlockVector = typename LocalResidual::LocalEvalBlockVector;
 
+    using ElementChunks = ThreadedEntityChunks<GridView, /*codim=*/0>;
+
     class BlockVectorWrapper
     {
     protected:
@@ -436,9 +465,12 @@ public:
 #else
         , space_( asImp_().numGridDof() )
 #endif
+        , dofOwnerSequenceNumber_(-1)
         , enableGridAdaptation_( EWOMS_GET_PARAM(TypeTag, bool, EnableGridAdaptation) )
         , enableIntensiveQuantityCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityCache))
+        , enableIntensiveQuantityPrepass_(EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityPrepass))
         , enableStorageCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache))
+        , enableStencilGeometryCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableStencilGeometryCache))
         , enableThermodynamicHints_(EWOMS_GET_PARAM(TypeTag, bool, EnableThermodynamicHints))
     {
 #if HAVE_DUNE_FEM
@@ -458,11 +490,16 @@ public:
 
         enableStorageCache_ = EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache);
 
+        leanIntensiveQuantityCache_ = EWOMS_GET_PARAM(TypeTag, bool, EnableLeanIntensiveQuantityCache);
+        if (leanIntensiveQuantityCache_ && !enableStorageCache_)
+            throw std::invalid_argument("The lean intensive quantity cache requires the storage "
+                                        "cache to be enabled");
+
         size_t numDof = asImp_().numGridDof();
         for (unsigned timeIdx = 0; timeIdx < historySize; ++timeIdx) {
             solution_[timeIdx].reset(new DiscreteFunction("solution", space_));
 
-            if (storeIntensiveQuantities()) {
+            if (storeIntensiveQuantities() && timeIdx < numIntensiveQuantityCacheSlots_()) {
                 intensiveQuantityCache_[timeIdx].resize(numDof);
                 intensiveQuantityCacheUpToDate_[timeIdx].resize(numDof, /*value=*/false);
             }
@@ -506,7 +543,15 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableVtkOutput, "Global switch for turning on writing VTK files");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableThermodynamicHints, "Enable thermodynamic hints");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntensiveQuantityCache, "Turn on caching of intensive quantities");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableIntensiveQuantityPrepass,
+                             "Compute the intensive quantities of all degrees of freedom before "
+                             "linearizing the elements");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableLeanIntensiveQuantityCache,
+                             "Only cache the intensive quantities of the most recent solution. "
+                             "This requires the storage cache.");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableStorageCache, "Store previous storage terms and avoid re-calculating them.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableStencilGeometryCache,
+                             "Pre-compute the geometry of the stencils once for each grid");
         EWOMS_REGISTER_PARAM(TypeTag, std::string, OutputDir, "The directory to which result files are written");
     }
 
@@ -515,6 +560,9 @@ public:
      */
     void finishInit()
     {
+        // the element contexts used below already need the geometry of the stencils
+        asImp_().updateStencilGeometry();
+
         // initialize the volume of the finite volumes to zero
         size_t numDof = asImp_().numGridDof();
         dofTotalVolume_.resize(numDof);
@@ -667,28 +715,13 @@ public:
     { return newtonMethod_; }
 
     /*!
-     * \brief Return the thermodynamic hint for a entity on the grid at given time.
-     *
-     * The hint is defined as a IntensiveQuantities object which is supposed to be
-     * "close" to the IntensiveQuantities of the current solution. It can be used as a
-     * good starting point for non-linear solvers when having to solve non-linear
-     * relations while updating the intensive quantities. (This may yield a major
-     * performance boost depending on how the physical models require.)
-     *
-     * \attention If no up-to date intensive quantities are available, or if hints have been
-     *            disabled, this method will return 0.
+     * \brief Returns true if thermodynamic hints are used to warm-start the non-linear
+     *        solvers which are required to update the intensive quantities.
      *
-     * \param globalIdx The global space index for the entity where a hint is requested.
-     * \param timeIdx The index used by the time discretization.
+     * The hints themselves are managed by the model.
      */
-    const IntensiveQuantities* thermodynamicHint(unsigned globalIdx, unsigned timeIdx) const
-    {
-        if (!enableThermodynamicHints_)
-            return 0;
-
-        // the intensive quantities cache doubles as thermodynamic hint
-        return cachedIntensiveQuantities(globalIdx, timeIdx);
-    }
+    bool enableThermodynamicHints() const
+    { return enableThermodynamicHints_; }
 
     /*!
      * \brief Return the cached intensive quantities for a entity on the
@@ -703,8 +736,7 @@ public:
      */
     const IntensiveQuantities* cachedIntensiveQuantities(unsigned globalIdx, unsigned timeIdx) const
     {
-        if (!enableIntensiveQuantityCache_ ||
-            !intensiveQuantityCacheUpToDate_[timeIdx][globalIdx])
+        if (!(enableIntensiveQuantityCache_ || enableIntensiveQuantityPrepass_))
             return 0;
 
         if (timeIdx > 0 && enableStorageCache_)
@@ -712,6 +744,9 @@ public:
             // recent time step are cached!
             return 0;
 
+        if (!intensiveQuantityCacheUpToDate_[timeIdx][globalIdx])
+            return 0;
+
         return &intensiveQuantityCache_[timeIdx][globalIdx];
     }
 
@@ -727,7 +762,7 @@ public:
                                          unsigned globalIdx,
                                          unsigned timeIdx) const
     {
-        if (!storeIntensiveQuantities())
+        if (!storeIntensiveQuantities() || timeIdx >= numIntensiveQuantityCacheSlots_())
             return;
 
         intensiveQuantityCache_[timeIdx][globalIdx] = intQuants;
@@ -745,7 +780,7 @@ public:
                                                   unsigned timeIdx,
                                                   bool newValue) const
     {
-        if (!storeIntensiveQuantities())
+        if (!storeIntensiveQuantities() || timeIdx >= numIntensiveQuantityCacheSlots_())
             return;
 
         intensiveQuantityCacheUpToDate_[timeIdx][globalIdx] = newValue;
@@ -770,7 +805,7 @@ public:
         invalidateIntensiveQuantitiesCache(timeIdx);
 
         // loop over all elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_, elementChunks());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -785,6 +820,67 @@ public:
         }
     }
 
+    /*!
+     * \brief Compute all intensive quantities which are not yet cached.
+     *
+     * This is a no-op unless the intensive quantity pre-pass or the intensive quantity
+     * cache is enabled. Afterwards, the element contexts only read the intensive
+     * quantities from the cache, i.e., the intensive quantities of each degree of
+     * freedom are evaluated exactly once per Newton iteration and the cache is not
+     * written to by concurrent linearization threads.
+     *
+     * If each degree of freedom is the primary degree of freedom of a single element,
+     * the elements are processed in parallel. Otherwise, each degree of freedom is
+     * evaluated by a single element which owns it.
+     */
+    void updateIntensiveQuantityCache() const
+    {
+        if (!enableIntensiveQuantityPrepass_ && !enableIntensiveQuantityCache_)
+            return;
+
+        if (!Implementation::primaryDofsAreExclusive()) {
+            updateIntensiveQuantityCachePerDof_();
+            return;
+        }
+
+        // with the storage cache enabled, only the most recent solution is required
+        unsigned numTimeIdx = enableStorageCache_ ? 1 : historySize;
+
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_, elementChunks());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator_);
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            try {
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    elemCtx.updatePrimaryStencil(*elemIt);
+                    for (unsigned timeIdx = 0; timeIdx < numTimeIdx; ++timeIdx)
+                        elemCtx.updatePrimaryIntensiveQuantities(timeIdx);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> take(exceptionLock);
+                exceptionPtr = std::current_exception();
+                threadedElemIt.setFinished();
+            }
+        }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+
+    /*!
+     * \brief Returns true if each degree of freedom is the primary degree of freedom of
+     *        exactly one element.
+     */
+    static constexpr bool primaryDofsAreExclusive()
+    { return false; }
+
     /*!
      * \brief Move the intensive quantities for a given time index to the back.
      *
@@ -833,7 +929,13 @@ public:
      * disabled will crash the program.
      */
     void setEnableStorageCache(bool enableStorageCache)
-    { enableStorageCache_= enableStorageCache; }
+    {
+        if (leanIntensiveQuantityCache_ && !enableStorageCache)
+            throw std::logic_error("The storage cache cannot be disabled if the lean "
+                                   "intensive quantity cache is used");
+
+        enableStorageCache_= enableStorageCache;
+    }
 
     /*!
      * \brief Retrieve an entry of the cache for the storage term.
@@ -880,8 +982,12 @@ public:
     {
         SolutionVector tmp(asImp_().solution(/*timeIdx=*/0));
         mutableSolution(/*timeIdx=*/0) = u;
+        // the cached intensive quantities belong to the current solution, not to u. they
+        // are re-computed for u by globalResidual(dest) before its threads access them.
+        invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
         Scalar res = asImp_().globalResidual(dest);
         mutableSolution(/*timeIdx=*/0) = tmp;
+        invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
         return res;
     }
 
@@ -895,8 +1001,12 @@ public:
     {
         dest = 0;
 
+        // fill the intensive quantity cache up-front, so that the threads below only
+        // read from it
+        updateIntensiveQuantityCache();
+
         std::mutex mutex;
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_, elementChunks());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -957,7 +1067,7 @@ public:
         storage = 0;
 
         std::mutex mutex;
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView());
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView(), elementChunks());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -1492,8 +1602,14 @@ public:
                                      +std::to_string(dofIdx));
         }
 
+        const auto& priVars = solution(/*timeIdx=*/0)[dofIdx];
+        if (BinaryRestart::isBinary(outstream)) {
+            outstream.write(reinterpret_cast<const char*>(&priVars[0]), numEq*sizeof(priVars[0]));
+            return;
+        }
+
         for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
-            outstream << solution(/*timeIdx=*/0)[dofIdx][eqIdx] << " ";
+            outstream << priVars[eqIdx] << " ";
         }
     }
 
@@ -1511,11 +1627,19 @@ public:
     {
         unsigned dofIdx = static_cast<unsigned>(asImp_().dofMapper().index(dof));
 
+        auto& priVars = solution(/*timeIdx=*/0)[dofIdx];
+        if (BinaryRestart::isBinary(instream)) {
+            if (!instream.read(reinterpret_cast<char*>(&priVars[0]), numEq*sizeof(priVars[0])))
+                throw std::runtime_error("Could not deserialize degree of freedom "
+                                         +std::to_string(dofIdx));
+            return;
+        }
+
         for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
             if (!instream.good())
                 throw std::runtime_error("Could not deserialize degree of freedom "
                                          +std::to_string(dofIdx));
-            instream >> solution(/*timeIdx=*/0)[dofIdx][eqIdx];
+            instream >> priVars[eqIdx];
         }
     }
 
@@ -1728,7 +1852,7 @@ public:
         }
 
         // iterate over grid
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView());
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView(), elementChunks());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -1776,6 +1900,22 @@ public:
     const GridView& gridView() const
     { return gridView_; }
 
+    /*!
+     * \brief Returns the chunks of elements which are distributed to the threads by
+     *        ThreadedEntityIterator.
+     *
+     * The chunks are re-determined if the grid has changed since they were last used.
+     * This method must be called from a sequential context.
+     */
+    const ElementChunks& elementChunks() const
+    {
+        int seqNum = simulator_.vanguard().gridSequenceNumber();
+        if (elementChunks_.sequenceNumber() != seqNum)
+            elementChunks_.update(gridView_, ThreadManager::chunkSize(), seqNum);
+
+        return elementChunks_;
+    }
+
     /*!
      * \brief Add a module for an auxiliary equation.
      *
@@ -1841,7 +1981,67 @@ public:
      * \brief Returns true if the cache for intensive quantities is enabled
      */
     bool storeIntensiveQuantities() const
-    { return enableIntensiveQuantityCache_ || enableThermodynamicHints_; }
+    {
+        return
+            enableIntensiveQuantityCache_
+            || enableIntensiveQuantityPrepass_;
+    }
+
+    /*!
+     * \brief Returns true if the intensive quantities are computed before the elements
+     *        are linearized.
+     */
+    bool enableIntensiveQuantityPrepass() const
+    { return enableIntensiveQuantityPrepass_; }
+
+    /*!
+     * \brief Returns true if the geometry of the stencils is pre-computed.
+     */
+    bool enableStencilGeometryCache() const
+    { return enableStencilGeometryCache_; }
+
+    /*!
+     * \brief Pre-compute the geometry of the stencils for the current grid.
+     *
+     * This is called by finishInit(), i.e., also after the grid has been adapted. The
+     * geometry is only re-computed if the grid has changed since it was last
+     * determined.
+     */
+    void updateStencilGeometry()
+    {
+        if (!enableStencilGeometryCache_)
+            return;
+
+        int seqNum = simulator_.vanguard().gridSequenceNumber();
+        if (stencilGeometry_.sequenceNumber() == seqNum)
+            return;
+
+        stencilGeometry_.update(gridView_, elementMapper_, vertexMapper_, seqNum);
+
+        size_t memoryUsage = gridView_.comm().sum(stencilGeometry_.memoryUsage());
+        if (simulator_.verbose())
+            std::cout << "Pre-computed the geometry of the stencils: "
+                      << memoryUsage/1024 << " KiB\n" << std::flush;
+    }
+
+    /*!
+     * \brief Prepare a newly created stencil object.
+     *
+     * If the geometry of the stencils is pre-computed, it is attached to the stencil.
+     */
+    void prepareStencil(Stencil& stencil) const
+    {
+        if (enableStencilGeometryCache_)
+            stencil.setGeometry(&stencilGeometry_);
+    }
+
+    /*!
+     * \brief Returns the pre-computed geometry of the stencils.
+     *
+     * This is only valid if the EnableStencilGeometryCache parameter is true.
+     */
+    const StencilGeometry& stencilGeometry() const
+    { return stencilGeometry_; }
 
 #if HAVE_DUNE_FEM
     AdaptationManager& adaptationManager()
@@ -1885,13 +2085,113 @@ protected:
         // allocate the intensive quantities cache
         if (storeIntensiveQuantities()) {
             size_t numDof = asImp_().numGridDof();
-            for(unsigned timeIdx=0; timeIdx<historySize; ++timeIdx) {
+            for(unsigned timeIdx=0; timeIdx<numIntensiveQuantityCacheSlots_(); ++timeIdx) {
                 intensiveQuantityCache_[timeIdx].resize(numDof);
                 intensiveQuantityCacheUpToDate_[timeIdx].resize(numDof);
                 invalidateIntensiveQuantitiesCache(timeIdx);
             }
         }
     }
+
+    // the number of time indices for which intensive quantities are cached
+    unsigned numIntensiveQuantityCacheSlots_() const
+    { return leanIntensiveQuantityCache_ ? 1 : historySize; }
+
+    // determine an element for each degree of freedom which has it as a primary degree
+    // of freedom. this only needs to be done once for each grid.
+    void updateDofOwners_() const
+    {
+        int seqNum = simulator_.vanguard().gridSequenceNumber();
+        if (dofOwnerSequenceNumber_ == seqNum)
+            return;
+
+        size_t numDof = asImp_().numGridDof();
+        dofOwnerSeed_.resize(numDof);
+        dofOwnerLocalIdx_.assign(numDof, std::numeric_limits<unsigned short>::max());
+
+        Stencil stencil(gridView_, asImp_().dofMapper());
+        asImp_().prepareStencil(stencil);
+        ElementIterator elemIt = gridView_.template begin</*codim=*/0>();
+        const ElementIterator& elemEndIt = gridView_.template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            stencil.updatePrimaryTopology(elem);
+            for (unsigned dofIdx = 0; dofIdx < stencil.numPrimaryDof(); ++dofIdx) {
+                unsigned globalIdx = stencil.globalSpaceIndex(dofIdx);
+                if (dofOwnerLocalIdx_[globalIdx] != std::numeric_limits<unsigned short>::max())
+                    continue;
+
+                dofOwnerSeed_[globalIdx] = elem.seed();
+                dofOwnerLocalIdx_[globalIdx] = static_cast<unsigned short>(dofIdx);
+            }
+        }
+
+        dofOwnerSequenceNumber_ = seqNum;
+    }
+
+    // the intensive quantity pre-pass which evaluates each degree of freedom using a
+    // single element which owns it. since no intensive quantities are computed twice,
+    // this is always multi-threaded.
+    void updateIntensiveQuantityCachePerDof_() const
+    {
+        updateDofOwners_();
+
+        // with the storage cache enabled, only the most recent solution is required
+        unsigned numTimeIdx = enableStorageCache_ ? 1 : historySize;
+
+        // evaluate the degrees of freedom. with a static schedule, each thread works on
+        // a contiguous range of them.
+        size_t numDof = dofOwnerLocalIdx_.size();
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> failed(false);
+        const Grid& grid = gridView_.grid();
+        const long numDofLong = static_cast<long>(numDof);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator_);
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (long i = 0; i < numDofLong; ++i) {
+                // an OpenMP loop cannot be left early, so skip the remaining work after
+                // an error occurred
+                if (failed.load(std::memory_order_relaxed))
+                    continue;
+
+                unsigned globalIdx = static_cast<unsigned>(i);
+                unsigned localIdx = dofOwnerLocalIdx_[globalIdx];
+                if (localIdx == std::numeric_limits<unsigned short>::max())
+                    continue; // not a primary degree of freedom of any element
+
+                bool upToDate = true;
+                for (unsigned timeIdx = 0; timeIdx < numTimeIdx; ++timeIdx)
+                    upToDate = upToDate && intensiveQuantityCacheUpToDate_[timeIdx][globalIdx];
+                if (upToDate)
+                    continue;
+
+                try {
+                    Element elem = grid.entity(dofOwnerSeed_[globalIdx]);
+                    elemCtx.updatePrimaryStencil(elem);
+                    for (unsigned timeIdx = 0; timeIdx < numTimeIdx; ++timeIdx)
+                        if (!intensiveQuantityCacheUpToDate_[timeIdx][globalIdx])
+                            elemCtx.updateIntensiveQuantitiesOfDof(localIdx, timeIdx);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> take(exceptionLock);
+                    exceptionPtr = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+
     template <class Context>
     void supplementInitialSolution_(PrimaryVariables& priVars OPM_UNUSED,
                                     const Context& context OPM_UNUSED,
@@ -1960,7 +2260,8 @@ protected:
     // cur is the current iterative solution, prev the converged
     // solution of the previous time step
     mutable IntensiveQuantitiesVector intensiveQuantityCache_[historySize];
-    mutable std::vector<bool> intensiveQuantityCacheUpToDate_[historySize];
+    // this is not a std::vector<bool> because its bits cannot be written concurrently
+    mutable std::vector<unsigned char> intensiveQuantityCacheUpToDate_[historySize];
 
     DiscreteFunctionSpace space_;
     mutable std::array< std::unique_ptr< DiscreteFunction >, historySize > solution_;
@@ -1979,10 +2280,23 @@ protected:
 
     mutable GlobalEqVector storageCache_[historySize];
 
+    mutable ElementChunks elementChunks_;
+
+    // for each degree of freedom, the element which has it as a primary degree of
+    // freedom and its local index in the element's stencil
+    mutable std::vector<ElementSeed> dofOwnerSeed_;
+    mutable std::vector<unsigned short> dofOwnerLocalIdx_;
+    mutable int dofOwnerSequenceNumber_;
+
     bool enableGridAdaptation_;
     bool enableIntensiveQuantityCache_;
+    bool enableIntensiveQuantityPrepass_;
     bool enableStorageCache_;
+    bool leanIntensiveQuantityCache_;
+    bool enableStencilGeometryCache_;
     bool enableThermodynamicHints_;
+
+    StencilGeometry stencilGeometry_;
 };
 } // namespace Opm
 
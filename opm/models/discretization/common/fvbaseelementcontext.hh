@@ -37,6 +37,7 @@
 
 #include <dune/common/fvector.hh>
 
+#include <utility>
 #include <vector>
 
 namespace Opm {
@@ -63,7 +64,11 @@ class FvBaseElementContext
     struct DofStore_ {
         IntensiveQuantities intensiveQuantities[timeDiscHistorySize];
         PrimaryVariables priVars[timeDiscHistorySize];
-        const IntensiveQuantities *thermodynamicHint[timeDiscHistorySize];
+    };
+    struct StashedDof_ {
+        IntensiveQuantities intensiveQuantities;
+        PrimaryVariables priVars;
+        unsigned dofIdx;
     };
     using DofVarsVector = std::vector<DofStore_>;
     using ExtensiveQuantitiesVector = std::vector<ExtensiveQuantities>;
@@ -97,8 +102,9 @@ public:
     {
         // remember the simulator object
         simulatorPtr_ = &simulator;
+        simulator.model().prepareStencil(stencil_);
         enableStorageCache_ = EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache);
-        stashedDofIdx_ = -1;
+        numStashedDofs_ = 0;
         focusDofIdx_ = -1;
     }
 
@@ -212,6 +218,23 @@ public:
     void updatePrimaryIntensiveQuantities(unsigned timeIdx)
     { updateIntensiveQuantities_(timeIdx, numPrimaryDof(timeIdx)); }
 
+    /*!
+     * \brief Compute the intensive quantities of a single sub-control volume of the
+     *        current element for a single time index using the global solution.
+     *
+     * If the intensive quantities are cached by the model, the cached object is used if
+     * it is up to date, else the cache is updated.
+     *
+     * \param dofIdx The local index in the current element of the sub-control volume
+     *               which should be updated.
+     * \param timeIdx The index of the solution vector used by the time discretization.
+     */
+    void updateIntensiveQuantitiesOfDof(unsigned dofIdx, unsigned timeIdx)
+    {
+        assert(dofIdx < dofVars_.size());
+        updateDofIntensiveQuantities_(dofIdx, timeIdx);
+    }
+
     /*!
      * \brief Compute the intensive quantities of a single sub-control volume of the
      *        current element for a single time index.
@@ -422,15 +445,15 @@ public:
     /*!
      * \brief Return the thermodynamic hint for a given local index.
      *
-     * \sa Discretization::thermodynamicHint(int, int)
+     * \sa MultiPhaseBaseModel::thermodynamicHint(unsigned, unsigned)
      *
      * \param dofIdx The local index of the degree of freedom in the current element.
      * \param timeIdx The index of the solution vector used by the time discretization.
      */
-    const IntensiveQuantities *thermodynamicHint(unsigned dofIdx, unsigned timeIdx) const
+    auto thermodynamicHint(unsigned dofIdx, unsigned timeIdx) const
     {
         assert(0 <= dofIdx && dofIdx < numDof(timeIdx));
-        return dofVars_[dofIdx].thermodynamicHint[timeIdx];
+        return model().thermodynamicHint(globalSpaceIndex(dofIdx, timeIdx), timeIdx);
     }
     /*!
      * \copydoc intensiveQuantities()
@@ -470,41 +493,65 @@ public:
      * calculated via finite difference methods.
      */
     bool haveStashedIntensiveQuantities() const
-    { return stashedDofIdx_ != -1; }
+    { return numStashedDofs_ > 0; }
 
     /*!
      * \brief Return the (local) index of the DOF for which the primary variables were
-     *        stashed
+     *        stashed most recently
      *
      * If none, then this returns -1.
      */
     int stashedDofIdx() const
-    { return stashedDofIdx_; }
+    {
+        if (numStashedDofs_ == 0)
+            return -1;
+        return static_cast<int>(stashedDofs_[numStashedDofs_ - 1].dofIdx);
+    }
 
     /*!
      * \brief Stash the intensive quantities for a degree of freedom on internal memory.
      *
+     * The quantities of several degrees of freedom can be stashed at the same time.
+     *
      * \param dofIdx The local index of the degree of freedom in the current element.
      */
     void stashIntensiveQuantities(unsigned dofIdx)
     {
         assert(0 <= dofIdx && dofIdx < numDof(/*timeIdx=*/0));
 
-        intensiveQuantitiesStashed_ = dofVars_[dofIdx].intensiveQuantities[/*timeIdx=*/0];
-        priVarsStashed_ = dofVars_[dofIdx].priVars[/*timeIdx=*/0];
-        stashedDofIdx_ = static_cast<int>(dofIdx);
+        // the stash never shrinks, so that its objects do not need to be re-allocated
+        if (numStashedDofs_ == stashedDofs_.size())
+            stashedDofs_.emplace_back();
+
+        auto& stash = stashedDofs_[numStashedDofs_++];
+        stash.intensiveQuantities = dofVars_[dofIdx].intensiveQuantities[/*timeIdx=*/0];
+        stash.priVars = dofVars_[dofIdx].priVars[/*timeIdx=*/0];
+        stash.dofIdx = dofIdx;
     }
 
     /*!
      * \brief Restores the intensive quantities for a degree of freedom from internal memory.
      *
+     * Restoring the degrees of freedom in the reverse order in which they were stashed
+     * is the cheapest.
+     *
      * \param dofIdx The local index of the degree of freedom in the current element.
      */
     void restoreIntensiveQuantities(unsigned dofIdx)
     {
-        dofVars_[dofIdx].priVars[/*timeIdx=*/0] = priVarsStashed_;
-        dofVars_[dofIdx].intensiveQuantities[/*timeIdx=*/0] = intensiveQuantitiesStashed_;
-        stashedDofIdx_ = -1;
+        assert(numStashedDofs_ > 0);
+
+        unsigned stashIdx = numStashedDofs_ - 1;
+        while (stashedDofs_[stashIdx].dofIdx != dofIdx) {
+            assert(stashIdx > 0);
+            -- stashIdx;
+        }
+        if (stashIdx != numStashedDofs_ - 1)
+            std::swap(stashedDofs_[stashIdx], stashedDofs_[numStashedDofs_ - 1]);
+
+        auto& stash = stashedDofs_[--numStashedDofs_];
+        dofVars_[dofIdx].priVars[/*timeIdx=*/0] = stash.priVars;
+        dofVars_[dofIdx].intensiveQuantities[/*timeIdx=*/0] = stash.intensiveQuantities;
     }
 
     /*!
@@ -555,28 +602,26 @@ protected:
      */
     void updateIntensiveQuantities_(unsigned timeIdx, size_t numDof)
     {
-        // update the intensive quantities for the whole history
-        const SolutionVector& globalSol = model().solution(timeIdx);
-
         // update the non-gradient quantities
-        for (unsigned dofIdx = 0; dofIdx < numDof; dofIdx++) {
-            unsigned globalIdx = globalSpaceIndex(dofIdx, timeIdx);
-            const PrimaryVariables& dofSol = globalSol[globalIdx];
-            dofVars_[dofIdx].priVars[timeIdx] = dofSol;
-
-            dofVars_[dofIdx].thermodynamicHint[timeIdx] =
-                model().thermodynamicHint(globalIdx, timeIdx);
-
-            const auto *cachedIntQuants = model().cachedIntensiveQuantities(globalIdx, timeIdx);
-            if (cachedIntQuants) {
-                dofVars_[dofIdx].intensiveQuantities[timeIdx] = *cachedIntQuants;
-            }
-            else {
-                updateSingleIntQuants_(dofSol, dofIdx, timeIdx);
-                model().updateCachedIntensiveQuantities(dofVars_[dofIdx].intensiveQuantities[timeIdx],
-                                                        globalIdx,
-                                                        timeIdx);
-            }
+        for (unsigned dofIdx = 0; dofIdx < numDof; dofIdx++)
+            updateDofIntensiveQuantities_(dofIdx, timeIdx);
+    }
+
+    void updateDofIntensiveQuantities_(unsigned dofIdx, unsigned timeIdx)
+    {
+        unsigned globalIdx = globalSpaceIndex(dofIdx, timeIdx);
+        const PrimaryVariables& dofSol = model().solution(timeIdx)[globalIdx];
+        dofVars_[dofIdx].priVars[timeIdx] = dofSol;
+
+        const auto *cachedIntQuants = model().cachedIntensiveQuantities(globalIdx, timeIdx);
+        if (cachedIntQuants) {
+            dofVars_[dofIdx].intensiveQuantities[timeIdx] = *cachedIntQuants;
+        }
+        else {
+            updateSingleIntQuants_(dofSol, dofIdx, timeIdx);
+            model().updateCachedIntensiveQuantities(dofVars_[dofIdx].intensiveQuantities[timeIdx],
+                                                    globalIdx,
+                                                    timeIdx);
         }
     }
 
@@ -592,8 +637,8 @@ protected:
         dofVars_[dofIdx].intensiveQuantities[timeIdx].update(/*context=*/asImp_(), dofIdx, timeIdx);
     }
 
-    IntensiveQuantities intensiveQuantitiesStashed_;
-    PrimaryVariables priVarsStashed_;
+    std::vector<StashedDof_, Opm::aligned_allocator<StashedDof_, alignof(StashedDof_)> > stashedDofs_;
+    unsigned numStashedDofs_;
 
     GradientCalculator gradientCalculator_;
 
@@ -605,7 +650,6 @@ protected:
     const GridView gridView_;
     Stencil stencil_;
 
-    int stashedDofIdx_;
     int focusDofIdx_;
     bool enableStorageCache_;
 };
@@ -41,7 +41,10 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
 #include <limits>
+#include <stdexcept>
+#include <vector>
 
 namespace Opm {
 // forward declaration
@@ -62,6 +65,10 @@ template<class TypeTag, class MyTypeTag>
 struct NumericDifferenceMethod { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct BaseEpsilon { using type = UndefinedProperty; };
+template<class TypeTag, class MyTypeTag>
+struct NumericDifferenceLocalVolumeTerms { using type = UndefinedProperty; };
+template<class TypeTag, class MyTypeTag>
+struct NumericDifferenceColoredColumns { using type = UndefinedProperty; };
 
 // set the properties to be spliced in
 template<class TypeTag>
@@ -82,6 +89,34 @@ struct Evaluation<TypeTag, TTag::FiniteDifferenceLocalLinearizer>
 template<class TypeTag>
 struct NumericDifferenceMethod<TypeTag, TTag::FiniteDifferenceLocalLinearizer> { static constexpr int value = +1; };
 
+/*!
+ * \brief Specify whether only the storage and source terms of the deflected degree of
+ *        freedom should be re-evaluated for a deflection.
+ *
+ * This assumes that the storage and source terms of a degree of freedom only depend on
+ * its own primary variables, which is the case unless the storage term uses extensive
+ * quantities or the source term of the problem looks at neighboring degrees of freedom.
+ */
+template<class TypeTag>
+struct NumericDifferenceLocalVolumeTerms<TypeTag, TTag::FiniteDifferenceLocalLinearizer> { static constexpr bool value = false; };
+
+/*!
+ * \brief Specify whether the primary variables of several degrees of freedom of an
+ *        element should be deflected at the same time.
+ *
+ * Two degrees of freedom are deflected together if there is no degree of freedom whose
+ * residual depends on both of them, so that all of them share a single evaluation of
+ * the local residual. This assumes that the flux over a sub-control volume face only
+ * depends on the two degrees of freedom adjacent to it, i.e., it cannot be used with
+ * P1 finite element gradients. The option is ignored if the storage term uses extensive
+ * quantities.
+ *
+ * Only stencils where some degrees of freedom are more than two faces apart profit from
+ * this, e.g., the vertex centered discretization on hexahedra.
+ */
+template<class TypeTag>
+struct NumericDifferenceColoredColumns<TypeTag, TTag::FiniteDifferenceLocalLinearizer> { static constexpr bool value = false; };
+
 //! The base epsilon value for finite difference calculations
 template<class TypeTag>
 struct BaseEpsilon<TypeTag, TTag::FiniteDifferenceLocalLinearizer>
@@ -141,11 +176,13 @@ private:
     using Model = GetPropType<TypeTag, Properties::Model>;
     using PrimaryVariables = GetPropType<TypeTag, Properties::PrimaryVariables>;
     using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
+    using GradientCalculator = GetPropType<TypeTag, Properties::GradientCalculator>;
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using Element = typename GridView::template Codim<0>::Entity;
 
     enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+    enum { extensiveStorageTerm = getPropValue<TypeTag, Properties::ExtensiveStorageTerm>() };
 
     // extract local matrices from jacobian matrix for consistency
     using ScalarMatrixBlock = typename GetPropType<TypeTag, Properties::SparseMatrixAdapter>::MatrixBlock;
@@ -155,6 +192,7 @@ private:
     using ScalarLocalBlockMatrix = Dune::Matrix<ScalarMatrixBlock>;
 
     using LocalEvalBlockVector = typename LocalResidual::LocalEvalBlockVector;
+    using EvalVector = typename LocalEvalBlockVector::block_type;
 
 #if __GNUC__ == 4 && __GNUC_MINOR__ <= 6
 public:
@@ -172,6 +210,9 @@ public:
 public:
     FvBaseFdLocalLinearizer()
         : internalElemContext_(0)
+        , localVolumeTerms_(false)
+        , coloredColumns_(false)
+        , numColors_(0)
     { }
 
     ~FvBaseFdLocalLinearizer()
@@ -185,6 +226,13 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, int, NumericDifferenceMethod,
                              "The method used for numeric differentiation (-1: backward "
                              "differences, 0: central differences, 1: forward differences)");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NumericDifferenceLocalVolumeTerms,
+                             "Only re-evaluate the storage and source terms of the deflected "
+                             "degree of freedom when computing finite differences");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, NumericDifferenceColoredColumns,
+                             "Deflect the primary variables of the degrees of freedom of "
+                             "an element which do not affect the same residual at the "
+                             "same time when computing finite differences");
     }
 
     /*!
@@ -198,6 +246,16 @@ public:
     void init(Simulator& simulator)
     {
         simulatorPtr_ = &simulator;
+        localVolumeTerms_ =
+            !extensiveStorageTerm
+            && EWOMS_GET_PARAM(TypeTag, bool, NumericDifferenceLocalVolumeTerms);
+        coloredColumns_ =
+            !extensiveStorageTerm
+            && EWOMS_GET_PARAM(TypeTag, bool, NumericDifferenceColoredColumns);
+        if (coloredColumns_ && !GradientCalculator::isFaceLocal())
+            throw std::invalid_argument("Deflecting several degrees of freedom at once "
+                                        "(NumericDifferenceColoredColumns) cannot be used "
+                                        "together with P1 finite element gradients");
         delete internalElemContext_;
         internalElemContext_ = new ElementContext(simulator);
     }
@@ -243,9 +301,29 @@ public:
         reset_(elemCtx);
 
         // calculate the local residual
-        localResidual_.eval(residual_, elemCtx);
+        if (localVolumeTerms_) {
+            // keep the flux and the volume terms separate, so that only the ones which
+            // are affected by a deflection need to be re-evaluated
+            localResidual_.evalFluxesAndBoundary(fluxResidual_, elemCtx);
+            localResidual_.evalVolumeTerms(residual_, elemCtx);
+            residual_ += fluxResidual_;
+
+            size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+            for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; dofIdx++)
+                localResidual_.evalCurrentVolumeTerms(volumeResidual_[dofIdx], elemCtx, dofIdx);
+        }
+        else
+            localResidual_.eval(residual_, elemCtx);
 
         // calculate the local jacobian matrix
+        if (coloredColumns_) {
+            colorColumns_(elemCtx);
+            for (unsigned colorIdx = 0; colorIdx < numColors_; ++colorIdx)
+                for (unsigned pvIdx = 0; pvIdx < numEq; pvIdx++)
+                    evalColoredPartialDerivatives_(elemCtx, colorIdx, pvIdx);
+            return;
+        }
+
         size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
         for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; dofIdx++) {
             for (unsigned pvIdx = 0; pvIdx < numEq; pvIdx++) {
@@ -257,6 +335,29 @@ public:
         }
     }
 
+    /*!
+     * \brief Only evaluate an element's residual and leave its local Jacobian matrix
+     *        alone.
+     *
+     * This avoids the numEq*numPrimaryDof additional evaluations of the local residual
+     * which are required to approximate the partial derivatives.
+     *
+     * \param elemCtx The element execution context for which the local residual should
+     *                be calculated.
+     */
+    void linearizeResidual(ElementContext& elemCtx, const Element& elem)
+    {
+        elemCtx.updateAll(elem);
+
+        // update the weights of the primary variables for the context
+        model_().updatePVWeights(elemCtx);
+
+        resize_(elemCtx);
+        reset_(elemCtx);
+
+        localResidual_.eval(residual_, elemCtx);
+    }
+
     /*!
      * \brief Returns the unweighted epsilon value used to calculate
      *        the local derivatives
@@ -350,6 +451,12 @@ protected:
         jacobian_.setSize(numDof, numPrimaryDof);
 
         derivResidual_.resize(numDof);
+
+        if (localVolumeTerms_) {
+            fluxResidual_.resize(numDof);
+            deflectedResidual_.resize(numDof);
+            volumeResidual_.resize(numPrimaryDof);
+        }
     }
 
     /*!
@@ -413,6 +520,11 @@ protected:
                                 unsigned dofIdx,
                                 unsigned pvIdx)
     {
+        if (localVolumeTerms_) {
+            evalPartialDerivativeLocalVolumeTerms_(elemCtx, dofIdx, pvIdx);
+            return;
+        }
+
         // save all quantities which depend on the specified primary
         // variable at the given sub control volume
         elemCtx.stashIntensiveQuantities(dofIdx);
@@ -480,6 +592,231 @@ protected:
 #endif
     }
 
+    /*!
+     * \brief Compute the partial derivatives of a context's residual functions if only
+     *        the volume terms of the deflected degree of freedom are re-evaluated.
+     *
+     * The deflection of a primary variable only affects the flux and boundary terms and
+     * the storage and source terms of the deflected degree of freedom. The storage terms
+     * of the previous time step and the volume terms of the remaining degrees of freedom
+     * are thus skipped. Otherwise, this does the same as evalPartialDerivative_().
+     */
+    void evalPartialDerivativeLocalVolumeTerms_(ElementContext& elemCtx,
+                                                unsigned dofIdx,
+                                                unsigned pvIdx)
+    {
+        elemCtx.stashIntensiveQuantities(dofIdx);
+
+        PrimaryVariables priVars(elemCtx.primaryVars(dofIdx, /*timeIdx=*/0));
+        Scalar eps = asImp_().numericEpsilon(elemCtx, dofIdx, pvIdx);
+        Scalar delta = 0.0;
+
+        EvalVector derivVolumeTerm;
+        if (numericDifferenceMethod_() >= 0) {
+            // calculate f(x + \epsilon)
+            priVars[pvIdx] += eps;
+            delta += eps;
+
+            elemCtx.updateIntensiveQuantities(priVars, dofIdx, /*timeIdx=*/0);
+            elemCtx.updateAllExtensiveQuantities();
+            localResidual_.evalFluxesAndBoundary(derivResidual_, elemCtx);
+            localResidual_.evalCurrentVolumeTerms(derivVolumeTerm, elemCtx, dofIdx);
+        }
+        else {
+            // recycle f(x)
+            derivResidual_ = fluxResidual_;
+            derivVolumeTerm = volumeResidual_[dofIdx];
+        }
+
+        if (numericDifferenceMethod_() <= 0) {
+            // calculate f(x - \epsilon)
+            priVars[pvIdx] -= delta + eps;
+            delta += eps;
+
+            EvalVector deflectedVolumeTerm;
+            elemCtx.updateIntensiveQuantities(priVars, dofIdx, /*timeIdx=*/0);
+            elemCtx.updateAllExtensiveQuantities();
+            localResidual_.evalFluxesAndBoundary(deflectedResidual_, elemCtx);
+            localResidual_.evalCurrentVolumeTerms(deflectedVolumeTerm, elemCtx, dofIdx);
+
+            derivResidual_ -= deflectedResidual_;
+            derivVolumeTerm -= deflectedVolumeTerm;
+        }
+        else {
+            // recycle f(x)
+            derivResidual_ -= fluxResidual_;
+            derivVolumeTerm -= volumeResidual_[dofIdx];
+        }
+
+        assert(delta > 0);
+
+        derivResidual_[dofIdx] += derivVolumeTerm;
+        derivResidual_ /= delta;
+
+        elemCtx.restoreIntensiveQuantities(dofIdx);
+
+#ifndef NDEBUG
+        for (unsigned i = 0; i < derivResidual_.size(); ++i)
+            Opm::Valgrind::CheckDefined(derivResidual_[i]);
+#endif
+    }
+
+    /*!
+     * \brief Assign the primary degrees of freedom of an element to groups which can be
+     *        deflected at the same time.
+     *
+     * Two degrees of freedom get the same color if they are not connected by a
+     * sub-control volume face and if there is no third degree of freedom to which both
+     * of them are connected.
+     */
+    void colorColumns_(const ElementContext& elemCtx)
+    {
+        const auto& stencil = elemCtx.stencil(/*timeIdx=*/0);
+        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+
+        // determine which residuals depend on the primary variables of which degrees of
+        // freedom
+        dofConnected_.assign(numDof*numDof, false);
+        for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx)
+            dofConnected_[dofIdx*numDof + dofIdx] = true;
+        for (unsigned faceIdx = 0; faceIdx < stencil.numInteriorFaces(); ++faceIdx) {
+            const auto& face = stencil.interiorFace(faceIdx);
+            unsigned i = face.interiorIndex();
+            unsigned j = face.exteriorIndex();
+            dofConnected_[i*numDof + j] = true;
+            dofConnected_[j*numDof + i] = true;
+        }
+
+        // greedily assign the first color which does not cause a conflict
+        columnColor_.resize(numPrimaryDof);
+        numColors_ = 0;
+        for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; ++dofIdx) {
+            unsigned colorIdx = 0;
+            for (; colorIdx < numColors_; ++colorIdx) {
+                bool conflict = false;
+                for (unsigned otherIdx = 0; otherIdx < dofIdx && !conflict; ++otherIdx)
+                    conflict =
+                        columnColor_[otherIdx] == colorIdx
+                        && shareResidual_(dofIdx, otherIdx, numDof);
+
+                if (!conflict)
+                    break;
+            }
+
+            columnColor_[dofIdx] = colorIdx;
+            numColors_ = std::max(numColors_, colorIdx + 1);
+        }
+    }
+
+    /*!
+     * \brief Returns true if the residual of a degree of freedom depends on the primary
+     *        variables of both given degrees of freedom.
+     */
+    bool shareResidual_(unsigned dof1Idx, unsigned dof2Idx, size_t numDof) const
+    {
+        for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx)
+            if (dofConnected_[dof1Idx*numDof + dofIdx] && dofConnected_[dof2Idx*numDof + dofIdx])
+                return true;
+        return false;
+    }
+
+    /*!
+     * \brief Compute the partial derivatives of a context's residual functions with
+     *        regard to a primary variable of all degrees of freedom of a color.
+     *
+     * The primary variables of all degrees of freedom of the color are deflected at the
+     * same time. Since the residual of each degree of freedom depends on at most one of
+     * them, the differences of the residuals can be attributed unambiguously. Otherwise,
+     * this does the same as evalPartialDerivative_().
+     */
+    void evalColoredPartialDerivatives_(ElementContext& elemCtx,
+                                        unsigned colorIdx,
+                                        unsigned pvIdx)
+    {
+        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+
+        coloredDofs_.clear();
+        for (unsigned dofIdx = 0; dofIdx < numPrimaryDof; ++dofIdx)
+            if (columnColor_[dofIdx] == colorIdx)
+                coloredDofs_.push_back(dofIdx);
+
+        if (coloredDofs_.size() == 1) {
+            asImp_().evalPartialDerivative_(elemCtx, coloredDofs_[0], pvIdx);
+            updateLocalJacobian_(elemCtx, coloredDofs_[0], pvIdx);
+            return;
+        }
+
+        size_t numColored = coloredDofs_.size();
+        coloredPriVars_.resize(numColored);
+        coloredEps_.resize(numColored);
+        for (unsigned i = 0; i < numColored; ++i) {
+            unsigned dofIdx = coloredDofs_[i];
+            elemCtx.stashIntensiveQuantities(dofIdx);
+            coloredPriVars_[i] = elemCtx.primaryVars(dofIdx, /*timeIdx=*/0);
+            coloredEps_[i] = asImp_().numericEpsilon(elemCtx, dofIdx, pvIdx);
+        }
+
+        Scalar deltaFactor = 0.0;
+        if (numericDifferenceMethod_() >= 0) {
+            // calculate f(x + \epsilon)
+            for (unsigned i = 0; i < numColored; ++i) {
+                PrimaryVariables priVars(coloredPriVars_[i]);
+                priVars[pvIdx] += coloredEps_[i];
+                elemCtx.updateIntensiveQuantities(priVars, coloredDofs_[i], /*timeIdx=*/0);
+            }
+            deltaFactor += 1.0;
+
+            elemCtx.updateAllExtensiveQuantities();
+            localResidual_.eval(derivResidual_, elemCtx);
+        }
+        else
+            // recycle f(x)
+            derivResidual_ = residual_;
+
+        if (numericDifferenceMethod_() <= 0) {
+            // calculate f(x - \epsilon)
+            for (unsigned i = 0; i < numColored; ++i) {
+                PrimaryVariables priVars(coloredPriVars_[i]);
+                priVars[pvIdx] -= coloredEps_[i];
+                elemCtx.updateIntensiveQuantities(priVars, coloredDofs_[i], /*timeIdx=*/0);
+            }
+            deltaFactor += 1.0;
+
+            elemCtx.updateAllExtensiveQuantities();
+            localResidual_.eval(elemCtx);
+
+            derivResidual_ -= localResidual_.residual();
+        }
+        else
+            // recycle f(x)
+            derivResidual_ -= residual_;
+
+        // attribute the difference of the residual of each degree of freedom to the
+        // deflected degree of freedom on which it depends. the remaining entries of the
+        // local Jacobian have been set to zero by reset_().
+        for (unsigned i = 0; i < numColored; ++i) {
+            unsigned focusDofIdx = coloredDofs_[i];
+            Scalar delta = deltaFactor*coloredEps_[i];
+            assert(delta > 0);
+
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+                if (!dofConnected_[focusDofIdx*numDof + dofIdx])
+                    continue;
+
+                for (unsigned eqIdx = 0; eqIdx < numEq; eqIdx++) {
+                    jacobian_[dofIdx][focusDofIdx][eqIdx][pvIdx] = derivResidual_[dofIdx][eqIdx]/delta;
+                    Opm::Valgrind::CheckDefined(jacobian_[dofIdx][focusDofIdx][eqIdx][pvIdx]);
+                }
+            }
+        }
+
+        // restore the original state of the element's volume variables
+        for (unsigned i = numColored; i > 0; --i)
+            elemCtx.restoreIntensiveQuantities(coloredDofs_[i - 1]);
+    }
+
     /*!
      * \brief Updates the current local Jacobian matrix with the partial derivatives of
      *        all equations for primary variable 'pvIdx' at the degree of freedom
@@ -511,6 +848,19 @@ protected:
     LocalEvalBlockVector derivResidual_;
     ScalarLocalBlockMatrix jacobian_;
 
+    bool localVolumeTerms_;
+    LocalEvalBlockVector fluxResidual_;
+    LocalEvalBlockVector deflectedResidual_;
+    LocalEvalBlockVector volumeResidual_;
+
+    bool coloredColumns_;
+    unsigned numColors_;
+    std::vector<unsigned char> dofConnected_;
+    std::vector<unsigned> columnColor_;
+    std::vector<unsigned> coloredDofs_;
+    std::vector<PrimaryVariables> coloredPriVars_;
+    std::vector<Scalar> coloredEps_;
+
     LocalResidual localResidual_;
 };
 
@@ -71,6 +71,13 @@ public:
     static void registerParameters()
     { }
 
+    /*!
+     * \brief Returns true if the values and gradients at a sub-control volume face only
+     *        depend on the two degrees of freedom adjacent to the face.
+     */
+    static constexpr bool isFaceLocal()
+    { return true; }
+
     /*!
      * \brief Precomputes the common values to calculate gradients and values of
      *        quantities at every interior flux approximation point.
@@ -34,7 +34,9 @@
 #include <opm/models/parallel/gridcommhandles.hh>
 #include <opm/models/parallel/threadmanager.hh>
 #include <opm/models/parallel/threadedentityiterator.hh>
+#include <opm/models/utils/profiler.hh>
 #include <opm/models/discretization/common/baseauxiliarymodule.hh>
+#include <opm/simulators/linalg/sparsitypattern.hh>
 
 #include <opm/material/common/Exceptions.hpp>
 
@@ -46,9 +48,10 @@
 #include <iostream>
 #include <vector>
 #include <thread>
-#include <set>
+#include <map>
 #include <exception>   // current_exception, rethrow_exception
 #include <mutex>
+#include <atomic>
 
 namespace Opm {
 // forward declarations
@@ -86,6 +89,7 @@ class FvBaseLinearizer
     using Constraints = GetPropType<TypeTag, Properties::Constraints>;
     using Stencil = GetPropType<TypeTag, Properties::Stencil>;
     using ThreadManager = GetPropType<TypeTag, Properties::ThreadManager>;
+    using Profiler = Opm::Profiler<TypeTag>;
 
     using GridCommHandleFactory = GetPropType<TypeTag, Properties::GridCommHandleFactory>;
 
@@ -93,6 +97,7 @@ class FvBaseLinearizer
 
     using Element = typename GridView::template Codim<0>::Entity;
     using ElementIterator = typename GridView::template Codim<0>::Iterator;
+    using ElementSeed = typename Element::EntitySeed;
 
     using Vector = GlobalEqVector;
 
@@ -105,6 +110,7 @@ class FvBaseLinearizer
     using VectorBlock = Dune::FieldVector<Scalar, numEq>;
 
     static const bool linearizeNonLocalElements = getPropValue<TypeTag, Properties::LinearizeNonLocalElements>();
+    static const bool useLinearizationLock = getPropValue<TypeTag, Properties::UseLinearizationLock>();
 
     // copying the linearizer is not a good idea
     FvBaseLinearizer(const FvBaseLinearizer&);
@@ -115,6 +121,8 @@ public:
         : jacobian_()
     {
         simulatorPtr_ = 0;
+        enableColoredLinearization_ = false;
+        residualOnly_ = false;
     }
 
     ~FvBaseLinearizer()
@@ -129,7 +137,12 @@ public:
      * \brief Register all run-time parameters for the Jacobian linearizer.
      */
     static void registerParameters()
-    { }
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableColoredLinearization,
+                             "Partition the elements into independent sets to avoid locking "
+                             "the global system of equations during multi-threaded "
+                             "linearization");
+    }
 
     /*!
      * \brief Initialize the linearizer.
@@ -143,6 +156,7 @@ public:
     void init(Simulator& simulator)
     {
         simulatorPtr_ = &simulator;
+        enableColoredLinearization_ = EWOMS_GET_PARAM(TypeTag, bool, EnableColoredLinearization);
         eraseMatrix();
         auto it = elementCtx_.begin();
         const auto& endIt = elementCtx_.end();
@@ -162,6 +176,9 @@ public:
     void eraseMatrix()
     {
         jacobian_.reset();
+        elementBlockOffsets_.clear();
+        elementBlocks_.clear();
+        elementColors_.clear();
     }
 
     /*!
@@ -197,29 +214,27 @@ public:
         if (!jacobian_)
             initFirstIteration_();
 
-        int succeeded;
-        try {
-            linearize_();
-            succeeded = 1;
-        }
-        catch (const std::exception& e)
-        {
-            std::cout << "rank " << simulator_().gridView().comm().rank()
-                      << " caught an exception while linearizing:" << e.what()
-                      << "\n"  << std::flush;
-            succeeded = 0;
-        }
-        catch (...)
-        {
-            std::cout << "rank " << simulator_().gridView().comm().rank()
-                      << " caught an exception while linearizing"
-                      << "\n"  << std::flush;
-            succeeded = 0;
-        }
-        succeeded = gridView_().comm().min(succeeded);
+        residualOnly_ = false;
+        linearizeDomainChecked_();
+    }
 
-        if (!succeeded)
-            throw Opm::NumericalIssue("A process did not succeed in linearizing the system");
+    /*!
+     * \brief Only evaluate the residual of the part of the non-linear system of
+     *        equations that is associated with the spatial domain.
+     *
+     * The global Jacobian matrix is left untouched, i.e., it is still the one of the
+     * last call to linearizeDomain(). The local linearizers skip the computation of
+     * the local Jacobians, which is particularly cheap for finite difference
+     * linearizers. Auxiliary equations are not considered.
+     */
+    void linearizeDomainResidual()
+    {
+        if (!jacobian_)
+            initFirstIteration_();
+
+        residualOnly_ = true;
+        linearizeDomainChecked_();
+        residualOnly_ = false;
     }
 
     void finalize()
@@ -320,6 +335,11 @@ private:
         // initialize the BCRS matrix for the Jacobian of the residual function
         createMatrix_();
 
+        // partition the elements into independent sets if lock-free linearization was
+        // requested
+        if (useElementColoring_())
+            createElementColoring_();
+
         // initialize the Jacobian matrix and the vector for the residual function
         residual_.resize(model_().numTotalDof());
         resetSystem_();
@@ -334,40 +354,183 @@ private:
     void createMatrix_()
     {
         const auto& model = model_();
-        Stencil stencil(gridView_(), model_().dofMapper());
 
         // for the main model, find out the global indices of the neighboring degrees of
-        // freedom of each primary degree of freedom
-        using NeighborSet = std::set< unsigned >;
-        std::vector<NeighborSet> sparsityPattern(model.numTotalDof());
+        // freedom of each primary degree of freedom. the pattern is assembled in two
+        // passes: first, the entries of each row are counted, then they are stored.
+        Opm::Linear::SparsityPattern sparsityPattern;
+        sparsityPattern.init(model.numTotalDof());
+        addSparsityPatternEntries_(sparsityPattern);
+        sparsityPattern.beginFill();
+        addSparsityPatternEntries_(sparsityPattern);
+        sparsityPattern.finalize();
+
+        // allocate raw matrix
+        jacobian_.reset(new SparseMatrixAdapter(simulator_()));
+
+        // create matrix structure based on sparsity pattern
+        jacobian_->reserve(sparsityPattern);
 
+        // the sparsity pattern is fixed from here on, so we can determine where the
+        // local Jacobians of the elements need to be added to
+        createScatterMap_();
+    }
+
+    // add the entries of the Jacobian matrix to a sparsity pattern. this is called once
+    // for the counting pass and once for the filling pass of the pattern.
+    void addSparsityPatternEntries_(Opm::Linear::SparsityPattern& sparsityPattern)
+    {
+        const auto& model = model_();
+
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_(), model_().elementChunks());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Stencil stencil(gridView_(), model.dofMapper());
+            model.prepareStencil(stencil);
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                const Element& elem = *elemIt;
+                stencil.update(elem);
+
+                for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
+                    unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
+
+                    for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
+                        unsigned neighborIdx = stencil.globalSpaceIndex(dofIdx);
+                        sparsityPattern.add(myIdx, neighborIdx);
+                    }
+                }
+            }
+        }
+
+        // add the additional neighbors and degrees of freedom caused by the auxiliary
+        // equations
+        size_t numAuxMod = model.numAuxiliaryModules();
+        for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
+            model.auxiliaryModule(auxModIdx)->addNeighbors(sparsityPattern);
+    }
+
+    // determine the addresses of the matrix blocks which are modified by the local
+    // Jacobian of each element. This avoids to search for the blocks in the rows of the
+    // sparse matrix for each element and linearization.
+    void createScatterMap_()
+    {
+        Stencil stencil(gridView_(), model_().dofMapper());
+        model_().prepareStencil(stencil);
+
+        size_t numElements = static_cast<size_t>(gridView_().size(/*codim=*/0));
+        elementBlockOffsets_.resize(numElements + 1);
+        elementBlocks_.clear();
+
+        // count the number of blocks for each element ...
         ElementIterator elemIt = gridView_().template begin<0>();
         const ElementIterator elemEndIt = gridView_().template end<0>();
         for (; elemIt != elemEndIt; ++elemIt) {
             const Element& elem = *elemIt;
+            unsigned elemIdx = elementMapper_().index(elem);
             stencil.update(elem);
+            elementBlockOffsets_[elemIdx + 1] = stencil.numPrimaryDof()*stencil.numDof();
+        }
 
-            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
-                unsigned myIdx = stencil.globalSpaceIndex(primaryDofIdx);
+        elementBlockOffsets_[0] = 0;
+        for (size_t elemIdx = 0; elemIdx < numElements; ++elemIdx)
+            elementBlockOffsets_[elemIdx + 1] += elementBlockOffsets_[elemIdx];
+        elementBlocks_.resize(elementBlockOffsets_[numElements]);
+
+        // ... and retrieve their addresses. for each primary DOF of the element, the
+        // blocks of all DOFs of the stencil are stored consecutively.
+        for (elemIt = gridView_().template begin<0>(); elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            unsigned elemIdx = elementMapper_().index(elem);
+            stencil.update(elem);
 
+            MatrixBlock** blockPtr = &elementBlocks_[elementBlockOffsets_[elemIdx]];
+            for (unsigned primaryDofIdx = 0; primaryDofIdx < stencil.numPrimaryDof(); ++primaryDofIdx) {
+                unsigned globI = stencil.globalSpaceIndex(primaryDofIdx);
                 for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
-                    unsigned neighborIdx = stencil.globalSpaceIndex(dofIdx);
-                    sparsityPattern[myIdx].insert(neighborIdx);
+                    unsigned globJ = stencil.globalSpaceIndex(dofIdx);
+                    *blockPtr++ = jacobian_->blockAddress(globJ, globI);
                 }
             }
         }
+    }
 
-        // add the additional neighbors and degrees of freedom caused by the auxiliary
-        // equations
-        size_t numAuxMod = model.numAuxiliaryModules();
-        for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
-            model.auxiliaryModule(auxModIdx)->addNeighbors(sparsityPattern);
+    // partition the elements into sets ("colors") such that no two elements of the same
+    // set share a degree of freedom. Since the linearization of an element only writes
+    // to the matrix rows and columns of the degrees of freedom in its stencil, the
+    // elements of a given color can be linearized concurrently without any locking.
+    void createElementColoring_()
+    {
+        Stencil stencil(gridView_(), model_().dofMapper());
+        model_().prepareStencil(stencil);
 
-        // allocate raw matrix
-        jacobian_.reset(new SparseMatrixAdapter(simulator_()));
+        // the colors of the elements which have already been colored, for each degree of
+        // freedom that is touched by them
+        std::vector<std::vector<unsigned> > dofColors(model_().numGridDof());
+        std::vector<bool> colorTaken;
 
-        // create matrix structure based on sparsity pattern
-        jacobian_->reserve(sparsityPattern);
+        elementColors_.clear();
+        ElementIterator elemIt = gridView_().template begin<0>();
+        const ElementIterator elemEndIt = gridView_().template end<0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
+                continue;
+
+            stencil.update(elem);
+
+            // greedily pick the first color which is not used by any element that shares
+            // a degree of freedom with the current one
+            colorTaken.assign(elementColors_.size(), false);
+            for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
+                unsigned globalIdx = stencil.globalSpaceIndex(dofIdx);
+                for (unsigned color : dofColors[globalIdx])
+                    colorTaken[color] = true;
+            }
+
+            unsigned color = 0;
+            while (color < colorTaken.size() && colorTaken[color])
+                ++color;
+
+            if (color == elementColors_.size())
+                elementColors_.emplace_back();
+            elementColors_[color].push_back(elem.seed());
+
+            for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx) {
+                unsigned globalIdx = stencil.globalSpaceIndex(dofIdx);
+                dofColors[globalIdx].push_back(color);
+            }
+        }
+    }
+
+    // linearize the domain and make sure that all processes succeeded
+    void linearizeDomainChecked_()
+    {
+        int succeeded;
+        try {
+            linearize_();
+            succeeded = 1;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while linearizing:" << e.what()
+                      << "\n"  << std::flush;
+            succeeded = 0;
+        }
+        catch (...)
+        {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while linearizing"
+                      << "\n"  << std::flush;
+            succeeded = 0;
+        }
+        succeeded = gridView_().comm().min(succeeded);
+
+        if (!succeeded)
+            throw Opm::NumericalIssue("A process did not succeed in linearizing the system");
     }
 
     // reset the global linear system of equations.
@@ -375,7 +538,8 @@ private:
     {
         residual_ = 0.0;
         // zero all matrix entries
-        jacobian_->clear();
+        if (!residualOnly_)
+            jacobian_->clear();
     }
 
     // query the problem for all constraint degrees of freedom. note that this method is
@@ -389,7 +553,7 @@ private:
         constraintsMap_.clear();
 
         // loop over all elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_(), model_().elementChunks());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -427,6 +591,8 @@ private:
     // linearize the whole system
     void linearize_()
     {
+        typename Profiler::Scope profilerScope(Profiler::Linearization);
+
         resetSystem_();
 
         // before the first iteration of each time step, we need to update the
@@ -437,6 +603,27 @@ private:
 
         applyConstraintsToSolution_();
 
+        // if requested, evaluate the intensive quantities of all degrees of freedom
+        // up-front so that the element contexts do not need to recompute those of their
+        // neighbors
+        {
+            typename Profiler::Scope iqProfilerScope(Profiler::IntensiveQuantities);
+            model_().updateIntensiveQuantityCache();
+        }
+
+        if (useElementColoring_())
+            linearizeColored_();
+        else
+            linearizeLocked_();
+
+        applyConstraintsToLinearization_();
+    }
+
+    // linearize all elements, each thread grabs the next element which is not yet
+    // worked on. the global matrix is protected by a lock if the discretization requires
+    // it.
+    void linearizeLocked_()
+    {
         // to avoid a race condition if two threads handle an exception at the same time,
         // we use an explicit lock to control access to the exception storage object
         // amongst thread-local handlers
@@ -447,11 +634,14 @@ private:
         std::exception_ptr exceptionPtr = nullptr;
 
         // relinearize the elements...
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_(), model_().elementChunks());
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
         {
+            // each thread records the time it spends on its share of the elements
+            typename Profiler::Scope profilerScope(Profiler::ElementLinearization);
+
             ElementIterator elemIt = threadedElemIt.beginParallel();
             ElementIterator nextElemIt = elemIt;
             try {
@@ -473,7 +663,7 @@ private:
                     if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
                         continue;
 
-                    linearizeElement_(elem);
+                    linearizeElement_(elem, /*useLock=*/useLinearizationLock);
                 }
             }
             // If an exception occurs in the parallel block, it won't escape the
@@ -498,12 +688,57 @@ private:
         if(exceptionPtr) {
             std::rethrow_exception(exceptionPtr);
         }
+    }
 
-        applyConstraintsToLinearization_();
+    // linearize all elements color by color. since elements of the same color do not
+    // share any degrees of freedom, no locking is required.
+    void linearizeColored_()
+    {
+        const auto& grid = gridView_().grid();
+
+        std::mutex exceptionLock;
+        std::exception_ptr exceptionPtr = nullptr;
+        std::atomic<bool> failed(false);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            // each thread records the time it spends on its share of the elements
+            typename Profiler::Scope profilerScope(Profiler::ElementLinearization);
+
+            for (const auto& colorSeeds : elementColors_) {
+                int numColorElems = static_cast<int>(colorSeeds.size());
+                // the implicit barrier at the end of the loop makes sure that a color
+                // is finished before the next one is started
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+                for (int i = 0; i < numColorElems; ++i) {
+                    if (failed.load(std::memory_order_relaxed))
+                        continue;
+
+                    try {
+                        const Element& elem = grid.entity(colorSeeds[i]);
+                        linearizeElement_(elem, /*useLock=*/false);
+                    }
+                    // exceptions cannot escape the parallel loop, so we bridge them out
+                    // of it. (see linearizeLocked_())
+                    catch(...) {
+                        std::lock_guard<std::mutex> take(exceptionLock);
+                        exceptionPtr = std::current_exception();
+                        failed = true;
+                    }
+                }
+            }
+        }
+
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
     }
 
     // linearize an element in the interior of the process' grid partition
-    void linearizeElement_(const Element& elem)
+    void linearizeElement_(const Element& elem, bool useLock)
     {
         unsigned threadId = ThreadManager::threadId();
 
@@ -511,28 +746,42 @@ private:
         auto& localLinearizer = model_().localLinearizer(threadId);
 
         // the actual work of linearization is done by the local linearizer class
-        localLinearizer.linearize(*elementCtx, elem);
+        {
+            typename Profiler::Scope profilerScope(Profiler::LocalLinearization);
+            if (residualOnly_)
+                localLinearizer.linearizeResidual(*elementCtx, elem);
+            else
+                localLinearizer.linearize(*elementCtx, elem);
+        }
+
+        typename Profiler::Scope profilerScope(Profiler::Scatter);
 
         // update the right hand side and the Jacobian matrix
-        if (getPropValue<TypeTag, Properties::UseLinearizationLock>())
+        if (useLock)
             globalMatrixMutex_.lock();
 
+        // the addresses of the matrix blocks affected by the element have been
+        // determined when the matrix was created
+        unsigned elemIdx = elementMapper_().index(elem);
+        MatrixBlock* const* blockPtr = &elementBlocks_[elementBlockOffsets_[elemIdx]];
+
         size_t numPrimaryDof = elementCtx->numPrimaryDof(/*timeIdx=*/0);
+        size_t numDof = elementCtx->numDof(/*timeIdx=*/0);
+        assert(elementBlockOffsets_[elemIdx + 1] - elementBlockOffsets_[elemIdx] == numPrimaryDof*numDof);
         for (unsigned primaryDofIdx = 0; primaryDofIdx < numPrimaryDof; ++ primaryDofIdx) {
             unsigned globI = elementCtx->globalSpaceIndex(/*spaceIdx=*/primaryDofIdx, /*timeIdx=*/0);
 
             // update the right hand side
             residual_[globI] += localLinearizer.residual(primaryDofIdx);
+            if (residualOnly_)
+                continue;
 
             // update the global Jacobian matrix
-            for (unsigned dofIdx = 0; dofIdx < elementCtx->numDof(/*timeIdx=*/0); ++ dofIdx) {
-                unsigned globJ = elementCtx->globalSpaceIndex(/*spaceIdx=*/dofIdx, /*timeIdx=*/0);
-
-                jacobian_->addToBlock(globJ, globI, localLinearizer.jacobian(dofIdx, primaryDofIdx));
-            }
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++ dofIdx)
+                *blockPtr[primaryDofIdx*numDof + dofIdx] += localLinearizer.jacobian(dofIdx, primaryDofIdx);
         }
 
-        if (getPropValue<TypeTag, Properties::UseLinearizationLock>())
+        if (useLock)
             globalMatrixMutex_.unlock();
     }
 
@@ -569,7 +818,8 @@ private:
 
             // reset the column of the Jacobian matrix
             // put an identity matrix on the main diagonal of the Jacobian
-            jacobian_->clearRow(constraintDofIdx, Scalar(1.0));
+            if (!residualOnly_)
+                jacobian_->clearRow(constraintDofIdx, Scalar(1.0));
 
             // make the right-hand side of constraint DOFs zero
             residual_[constraintDofIdx] = 0.0;
@@ -579,6 +829,11 @@ private:
     static bool enableConstraints_()
     { return getPropValue<TypeTag, Properties::EnableConstraints>(); }
 
+    // element coloring is only required if concurrent linearization of two elements
+    // can lead to race conditions, i.e., if the discretization needs the lock
+    bool useElementColoring_() const
+    { return useLinearizationLock && enableColoredLinearization_; }
+
     Simulator *simulatorPtr_;
     std::vector<ElementContext*> elementCtx_;
 
@@ -595,6 +850,19 @@ private:
     LinearizationType linearizationType_;
 
     std::mutex globalMatrixMutex_;
+
+    // the addresses of the matrix blocks which are written by the local Jacobian of each
+    // element. (the blocks of element i are stored in the range [offsets[i],
+    // offsets[i+1]).)
+    std::vector<size_t> elementBlockOffsets_;
+    std::vector<MatrixBlock*> elementBlocks_;
+
+    // the seeds of the elements of each color for lock-free linearization
+    std::vector<std::vector<ElementSeed> > elementColors_;
+    bool enableColoredLinearization_;
+
+    // true while only the residual is evaluated by linearizeDomainResidual()
+    bool residualOnly_;
 };
 
 } // namespace Opm
@@ -32,6 +32,7 @@
 
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/models/utils/alignedallocator.hh>
+#include <opm/models/utils/profiler.hh>
 
 #include <opm/material/common/Valgrind.hpp>
 #include <opm/material/common/Unused.hpp>
@@ -59,6 +60,7 @@ class FvBaseLocalResidual
 {
 private:
     using Implementation = GetPropType<TypeTag, Properties::LocalResidual>;
+    using Profiler = Opm::Profiler<TypeTag>;
 
     using GridView = GetPropType<TypeTag, Properties::GridView>;
     using Element = typename GridView::template Codim<0>::Entity;
@@ -164,7 +166,10 @@ public:
         residual = 0.0;
 
         // evaluate the flux terms
-        asImp_().evalFluxes(residual, elemCtx, /*timeIdx=*/0);
+        {
+            typename Profiler::Scope profilerScope(Profiler::FluxEvaluation);
+            asImp_().evalFluxes(residual, elemCtx, /*timeIdx=*/0);
+        }
 
         // evaluate the storage and the source terms
         asImp_().evalVolumeTerms_(residual, elemCtx);
@@ -172,22 +177,90 @@ public:
         // evaluate the boundary conditions
         asImp_().evalBoundary_(residual, elemCtx, /*timeIdx=*/0);
 
-        if (useVolumetricResidual) {
-            // make the residual volume specific (i.e., make it incorrect mass per cubic
-            // meter instead of total mass)
-            size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
-            for (unsigned dofIdx=0; dofIdx < numDof; ++dofIdx) {
-                if (elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0) > 0.0) {
-                    // interior DOF
-                    Scalar dofVolume = elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0);
+        makeVolumetric_(residual, elemCtx);
+    }
 
-                    assert(std::isfinite(dofVolume));
-                    Opm::Valgrind::CheckDefined(dofVolume);
+    /*!
+     * \brief Compute the flux and boundary terms of the local residual.
+     *
+     * Adding the result of evalVolumeTerms() to this yields the same as eval().
+     *
+     * \copydetails Doxygen::residualParam
+     * \copydetails Doxygen::ecfvElemCtxParam
+     */
+    void evalFluxesAndBoundary(LocalEvalBlockVector& residual,
+                               ElementContext& elemCtx) const
+    {
+        assert(residual.size() == elemCtx.numDof(/*timeIdx=*/0));
 
-                    for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
-                        residual[dofIdx][eqIdx] /= dofVolume;
-                }
-            }
+        residual = 0.0;
+        {
+            typename Profiler::Scope profilerScope(Profiler::FluxEvaluation);
+            asImp_().evalFluxes(residual, elemCtx, /*timeIdx=*/0);
+        }
+        asImp_().evalBoundary_(residual, elemCtx, /*timeIdx=*/0);
+
+        makeVolumetric_(residual, elemCtx);
+    }
+
+    /*!
+     * \brief Compute the storage and source terms of the local residual.
+     *
+     * \copydetails Doxygen::residualParam
+     * \copydetails Doxygen::ecfvElemCtxParam
+     */
+    void evalVolumeTerms(LocalEvalBlockVector& residual,
+                         ElementContext& elemCtx) const
+    {
+        assert(residual.size() == elemCtx.numDof(/*timeIdx=*/0));
+
+        residual = 0.0;
+        asImp_().evalVolumeTerms_(residual, elemCtx);
+
+        makeVolumetric_(residual, elemCtx);
+    }
+
+    /*!
+     * \brief Compute the part of the storage and source terms of a primary degree of
+     *        freedom which depends on the current solution.
+     *
+     * In contrast to the storage term of the residual, the storage of the previous time
+     * step is not subtracted. The result thus only differs from the corresponding
+     * volume term of the residual by a value which does not depend on the current
+     * solution.
+     *
+     * \param residual Stores the result
+     * \copydetails Doxygen::ecfvElemCtxParam
+     * \param dofIdx The local index of the primary degree of freedom
+     */
+    void evalCurrentVolumeTerms(EvalVector& residual,
+                                ElementContext& elemCtx,
+                                unsigned dofIdx) const
+    {
+        assert(dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0));
+
+        Scalar extrusionFactor =
+            elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0).extrusionFactor();
+        Scalar scvVolume =
+            elemCtx.stencil(/*timeIdx=*/0).subControlVolume(dofIdx).volume() * extrusionFactor;
+        double dt = elemCtx.simulator().timeStepSize();
+        assert(dt > 0);
+
+        residual = 0.0;
+        asImp_().computeStorage(residual, elemCtx, dofIdx, /*timeIdx=*/0);
+
+        RateVector sourceRate;
+        asImp_().computeSource(sourceRate, elemCtx, dofIdx, /*timeIdx=*/0);
+
+        for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+            residual[eqIdx] *= scvVolume / dt;
+            residual[eqIdx] -= sourceRate[eqIdx]*scvVolume;
+        }
+
+        if (useVolumetricResidual && elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0) > 0.0) {
+            Scalar dofVolume = elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0);
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                residual[eqIdx] /= dofVolume;
         }
     }
 
@@ -414,6 +487,32 @@ public:
     }
 
 protected:
+    /*!
+     * \brief Make the residual volume specific if requested by the model.
+     *
+     * I.e., the result is the incorrect mass per cubic meter instead of the total mass.
+     */
+    void makeVolumetric_(LocalEvalBlockVector& residual,
+                         const ElementContext& elemCtx) const
+    {
+        if (!useVolumetricResidual)
+            return;
+
+        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        for (unsigned dofIdx=0; dofIdx < numDof; ++dofIdx) {
+            if (elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0) > 0.0) {
+                // interior DOF
+                Scalar dofVolume = elemCtx.dofTotalVolume(dofIdx, /*timeIdx=*/0);
+
+                assert(std::isfinite(dofVolume));
+                Opm::Valgrind::CheckDefined(dofVolume);
+
+                for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx)
+                    residual[dofIdx][eqIdx] /= dofVolume;
+            }
+        }
+    }
+
     /*!
      * \brief Evaluate the boundary conditions of an element.
      */
@@ -32,6 +32,7 @@
 
 #include <opm/models/nonlinear/newtonmethod.hh>
 #include <opm/models/utils/propertysystem.hh>
+#include <opm/models/utils/profiler.hh>
 
 namespace Opm {
 
@@ -143,7 +144,10 @@ protected:
      */
     void beginIteration_()
     {
-        model_().syncOverlap();
+        {
+            typename Opm::Profiler<TypeTag>::Scope profilerScope(Opm::Profiler<TypeTag>::OverlapSync);
+            model_().syncOverlap();
+        }
 
         ParentType::beginIteration_();
     }
@@ -33,6 +33,7 @@
 #include <opm/models/io/vtkmultiwriter.hh>
 #include <opm/models/io/restart.hh>
 #include <opm/models/discretization/common/restrictprolong.hh>
+#include <opm/models/utils/profiler.hh>
 
 #include <opm/material/common/Unused.hpp>
 #include <dune/common/fvector.hh>
@@ -505,6 +506,8 @@ public:
                       << "\n"
                       << std::flush;
         }
+
+        Opm::Profiler<TypeTag>::finalize(gridView().comm());
     }
 
     /*!
@@ -788,6 +791,8 @@ public:
         if (!enableVtkOutput_())
             return;
 
+        typename Opm::Profiler<TypeTag>::Scope profilerScope(Opm::Profiler<TypeTag>::Output);
+
         if (verbose && gridView().comm().rank() == 0)
             std::cout << "Writing visualization results for the current time step.\n"
                       << std::flush;
@@ -188,6 +188,9 @@ template<class TypeTag, class MyTypeTag>
 struct ThreadManager { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct ThreadsPerProcess { using type = UndefinedProperty; };
+//! The number of consecutive grid entities which are handed to a thread at a time
+template<class TypeTag, class MyTypeTag>
+struct ThreadChunkSize { using type = UndefinedProperty; };
 
 //! use locking to prevent race conditions when linearizing the global system of
 //! equations in multi-threaded mode. (setting this property to true is always save, but
@@ -196,6 +199,17 @@ struct ThreadsPerProcess { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct UseLinearizationLock { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specify whether the elements should be partitioned into independent sets
+ *        ("colors") for multi-threaded linearization.
+ *
+ * Elements of the same color do not share any degree of freedom, so they can be
+ * linearized concurrently without locking the global system of equations. This only has
+ * an effect for discretizations which require the linearization lock.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableColoredLinearization { using type = UndefinedProperty; };
+
 // high-level simulation control
 
 /*!
@@ -289,10 +303,46 @@ struct ContinueOnConvergenceError { using type = UndefinedProperty; };
  * higher memory consumption. In turn, the higher memory requirements
  * may cause the simulation to exhibit worse cache coherence behavior
  * which eats some of the computational benefits again.
+ *
+ * If the cache is enabled, it is filled before the elements are linearized, i.e.,
+ * the linearization only reads from it.
  */
 template<class TypeTag, class MyTypeTag>
 struct EnableIntensiveQuantityCache { using type = UndefinedProperty; };
 
+/*!
+ * \brief Specify whether the intensive quantities of all degrees of freedom should be
+ *        computed in a separate pass before the elements are linearized.
+ *
+ * This uses the storage of the intensive quantity cache. During the linearization
+ * itself, the intensive quantities of the neighbors of an element are then only read,
+ * i.e., they are evaluated once per Newton iteration instead of once per adjacent
+ * element.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableIntensiveQuantityPrepass { using type = UndefinedProperty; };
+
+/*!
+ * \brief Specify whether only the intensive quantities of the most recent solution
+ *        should be cached.
+ *
+ * This halves the memory required by the intensive quantity cache for the default
+ * implicit Euler time discretization, but it requires the storage cache to be enabled.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableLeanIntensiveQuantityCache { using type = UndefinedProperty; };
+
+/*!
+ * \brief Specify whether the static geometry of the stencils should be pre-computed.
+ *
+ * If enabled, the volumes and centers of all degrees of freedom as well as the areas,
+ * normals and centers of all faces are computed once for each grid and the stencils
+ * copy them from flat arrays instead of querying the grid. Discretizations which do
+ * not support this ignore the parameter.
+ */
+template<class TypeTag, class MyTypeTag>
+struct EnableStencilGeometryCache { using type = UndefinedProperty; };
+
 /*!
  * \brief Specify whether the storage terms for previous solutions should be cached.
  *
@@ -32,6 +32,7 @@
 
 #include "ecfvproperties.hh"
 #include "ecfvstencil.hh"
+#include "ecfvstencilgeometry.hh"
 #include "ecfvgridcommhandlefactory.hh"
 #include "ecfvbaseoutputmodule.hh"
 
@@ -165,6 +166,16 @@ public:
     const DofMapper& dofMapper() const
     { return this->elementMapper(); }
 
+    /*!
+     * \brief Returns true if each degree of freedom is the primary degree of freedom of
+     *        exactly one element.
+     *
+     * For the element centered finite volume discretization, the element itself is the
+     * only primary degree of freedom of its stencil.
+     */
+    static constexpr bool primaryDofsAreExclusive()
+    { return true; }
+
     /*!
      * \brief Syncronize the values of the primary variables on the
      *        degrees of freedom that overlap with the neighboring
@@ -28,6 +28,8 @@
 #ifndef EWOMS_ECFV_STENCIL_HH
 #define EWOMS_ECFV_STENCIL_HH
 
+#include "ecfvstencilgeometry.hh"
+
 #include <opm/models/utils/quadraturegeometries.hh>
 
 #include <opm/material/common/ConditionalStorage.hpp>
@@ -50,6 +52,10 @@ namespace Opm {
  * The ECFV discretization is a element centered finite volume
  * approach. This means that each element corresponds to a control
  * volume.
+ *
+ * If an EcfvStencilGeometry object is attached to the stencil via setGeometry(), the
+ * geometry and the topology of the stencil are taken from it instead of being
+ * determined using the intersection iterator of the grid view.
  */
 template <class Scalar,
           class GridView,
@@ -72,6 +78,7 @@ class EcfvStencil
 public:
     using Entity = Element       ;
     using Mapper = ElementMapper ;
+    using StencilGeometry = EcfvStencilGeometry<Scalar, GridView>;
 
     using LocalGeometry = typename Element::Geometry;
 
@@ -95,6 +102,12 @@ public:
             : element_(element)
         { update(); }
 
+        SubControlVolume(const Element& element, const GlobalPosition& centerPos, Scalar volume)
+            : centerPos_(centerPos)
+            , volume_(volume)
+            , element_(element)
+        { }
+
         void update(const Element& element)
         { element_ = element; }
 
@@ -164,6 +177,19 @@ public:
             area_ = geometry.volume();
         }
 
+        EcfvSubControlVolumeFace(const StencilGeometry& stencilGeometry,
+                                 size_t faceIdx,
+                                 unsigned localNeighborIdx)
+        {
+            exteriorIdx_ = static_cast<unsigned short>(localNeighborIdx);
+
+            if (needNormal)
+                (*normal_) = stencilGeometry.faceNormal(faceIdx);
+            if (needIntegrationPos)
+                (*integrationPos_) = stencilGeometry.faceCenter(faceIdx);
+            area_ = stencilGeometry.faceArea(faceIdx);
+        }
+
         /*!
          * \brief Returns the local index of the degree of freedom to
          *        the face's interior.
@@ -219,13 +245,28 @@ public:
     EcfvStencil(const GridView& gridView, const Mapper& mapper)
         : gridView_(gridView)
         , elementMapper_(mapper)
+        , geometry_(nullptr)
     {
         // try to ensure that the mapper passed indeed maps elements
         assert(int(gridView.size(/*codim=*/0)) == int(elementMapper_.size()));
     }
 
+    /*!
+     * \brief Use pre-computed geometry and topology information.
+     *
+     * The object must have been updated for the current grid. If nullptr is passed, the
+     * intersections of the grid view are used.
+     */
+    void setGeometry(const StencilGeometry* geometry)
+    { geometry_ = geometry; }
+
     void updateTopology(const Element& element)
     {
+        if (geometry_) {
+            updateTopologyFromGeometry_(element);
+            return;
+        }
+
         auto isIt = gridView_.ibegin(element);
         const auto& endIsIt = gridView_.iend(element);
 
@@ -258,7 +299,14 @@ public:
     {
         // add the "center" element of the stencil
         subControlVolumes_.clear();
-        subControlVolumes_.emplace_back(/*SubControlVolume(*/element/*)*/);
+        if (geometry_) {
+            unsigned elemIdx = static_cast<unsigned>(elementMapper_.index(element));
+            subControlVolumes_.emplace_back(element,
+                                            geometry_->cellCenter(elemIdx),
+                                            geometry_->cellVolume(elemIdx));
+        }
+        else
+            subControlVolumes_.emplace_back(/*SubControlVolume(*/element/*)*/);
         elements_.clear();
         elements_.emplace_back(element);
     }
@@ -379,8 +427,45 @@ public:
     { return boundaryFaces_[bfIdx]; }
 
 protected:
+    void updateTopologyFromGeometry_(const Element& element)
+    {
+        assert(geometry_->numElements() == static_cast<size_t>(gridView_.size(/*codim=*/0)));
+
+        unsigned elemIdx = static_cast<unsigned>(elementMapper_.index(element));
+
+        // add the "center" element of the stencil
+        subControlVolumes_.clear();
+        subControlVolumes_.emplace_back(element,
+                                        geometry_->cellCenter(elemIdx),
+                                        geometry_->cellVolume(elemIdx));
+        elements_.clear();
+        elements_.emplace_back(element);
+
+        interiorFaces_.clear();
+        boundaryFaces_.clear();
+
+        // the faces are stored in the same order as they are visited by the
+        // intersection iterator, so the local indices of the degrees of freedom are the
+        // same as in updateTopology()
+        size_t faceEnd = geometry_->faceEnd(elemIdx);
+        for (size_t faceIdx = geometry_->faceBegin(elemIdx); faceIdx < faceEnd; ++faceIdx) {
+            int neighborIdx = geometry_->faceNeighbor(faceIdx);
+            if (neighborIdx >= 0) {
+                unsigned nIdx = static_cast<unsigned>(neighborIdx);
+                elements_.emplace_back(geometry_->element(gridView_.grid(), nIdx));
+                subControlVolumes_.emplace_back(elements_.back(),
+                                                geometry_->cellCenter(nIdx),
+                                                geometry_->cellVolume(nIdx));
+                interiorFaces_.emplace_back(*geometry_, faceIdx, subControlVolumes_.size() - 1);
+            }
+            else
+                boundaryFaces_.emplace_back(*geometry_, faceIdx, - 10000);
+        }
+    }
+
     const GridView&       gridView_;
     const ElementMapper&  elementMapper_;
+    const StencilGeometry* geometry_;
 
     std::vector<Element> elements_;
     std::vector<SubControlVolume>      subControlVolumes_;
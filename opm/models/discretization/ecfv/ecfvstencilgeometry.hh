@@ -0,0 +1,252 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::EcfvStencilGeometry
+ */
+#ifndef EWOMS_ECFV_STENCIL_GEOMETRY_HH
+#define EWOMS_ECFV_STENCIL_GEOMETRY_HH
+
+#include <opm/material/common/Unused.hpp>
+
+#include <dune/common/fvector.hh>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+/*!
+ * \ingroup EcfvDiscretization
+ *
+ * \brief Stores the static geometry and the connectivity of all elements of a grid
+ *        view in flat arrays.
+ *
+ * For each element, the volume, the center and the entity seed are stored. The
+ * intersections of the elements are stored in compressed row format: The intersections
+ * of the element with index \c elemIdx are the range [faceBegin(elemIdx),
+ * faceEnd(elemIdx)[ and they are stored in the order in which they are visited by the
+ * intersection iterator of the grid view. For each of them, the index of the neighboring
+ * element (or -1 if the intersection does not have a neighbor), the area, the outer unit
+ * normal and the center are stored.
+ *
+ * Since building these arrays requires a sequential iteration over the grid, the
+ * sequence number of the grid for which they were built is stored to detect grid
+ * modifications.
+ */
+template <class Scalar, class GridView>
+class EcfvStencilGeometry
+{
+    enum { dimWorld = GridView::dimensionworld };
+
+    using CoordScalar = typename GridView::ctype;
+    using Element = typename GridView::template Codim<0>::Entity;
+    using ElementIterator = typename GridView::template Codim<0>::Iterator;
+    using EntitySeed = typename Element::EntitySeed;
+
+public:
+    using GlobalPosition = Dune::FieldVector<CoordScalar, dimWorld>;
+    using WorldVector = Dune::FieldVector<Scalar, dimWorld>;
+
+    EcfvStencilGeometry()
+        : sequenceNumber_(-1)
+    { }
+
+    /*!
+     * \brief Determine the geometry of all elements of a grid view.
+     *
+     * \param gridView The grid view for which the geometry is determined
+     * \param elementMapper The mapper from the elements to their indices
+     * \param vertexMapper The mapper from the vertices to their indices. It is not
+     *                     required for cell centered stencils.
+     * \param sequenceNumber The sequence number of the grid
+     */
+    template <class ElementMapper, class VertexMapper>
+    void update(const GridView& gridView,
+                const ElementMapper& elementMapper,
+                const VertexMapper& vertexMapper OPM_UNUSED,
+                int sequenceNumber)
+    {
+        size_t numElements = static_cast<size_t>(gridView.size(/*codim=*/0));
+
+        seeds_.resize(numElements);
+        cellVolume_.resize(numElements);
+        cellCenter_.resize(numElements);
+
+        // count the intersections of each element
+        faceOffsets_.assign(numElements + 1, 0);
+        ElementIterator elemIt = gridView.template begin</*codim=*/0>();
+        const ElementIterator& elemEndIt = gridView.template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const auto& elem = *elemIt;
+            unsigned elemIdx = static_cast<unsigned>(elementMapper.index(elem));
+            auto isIt = gridView.ibegin(elem);
+            const auto& endIsIt = gridView.iend(elem);
+            for (; isIt != endIsIt; ++isIt)
+                ++ faceOffsets_[elemIdx + 1];
+        }
+        for (size_t elemIdx = 0; elemIdx < numElements; ++elemIdx)
+            faceOffsets_[elemIdx + 1] += faceOffsets_[elemIdx];
+
+        size_t numFaces = faceOffsets_[numElements];
+        faceNeighbor_.resize(numFaces);
+        faceArea_.resize(numFaces);
+        faceNormal_.resize(numFaces);
+        faceCenter_.resize(numFaces);
+
+        // store the geometry of the elements and of their intersections
+        for (elemIt = gridView.template begin</*codim=*/0>(); elemIt != elemEndIt; ++elemIt) {
+            const auto& elem = *elemIt;
+            unsigned elemIdx = static_cast<unsigned>(elementMapper.index(elem));
+            const auto& elemGeometry = elem.geometry();
+            seeds_[elemIdx] = elem.seed();
+            cellVolume_[elemIdx] = elemGeometry.volume();
+            cellCenter_[elemIdx] = elemGeometry.center();
+
+            size_t faceIdx = faceOffsets_[elemIdx];
+            auto isIt = gridView.ibegin(elem);
+            const auto& endIsIt = gridView.iend(elem);
+            for (; isIt != endIsIt; ++isIt, ++faceIdx) {
+                const auto& intersection = *isIt;
+                const auto& isGeometry = intersection.geometry();
+
+                if (intersection.neighbor())
+                    faceNeighbor_[faceIdx] = static_cast<int>(elementMapper.index(intersection.outside()));
+                else
+                    faceNeighbor_[faceIdx] = -1;
+
+                faceArea_[faceIdx] = isGeometry.volume();
+                faceNormal_[faceIdx] = intersection.centerUnitOuterNormal();
+                faceCenter_[faceIdx] = isGeometry.center();
+            }
+            assert(faceIdx == faceOffsets_[elemIdx + 1]);
+        }
+
+        sequenceNumber_ = sequenceNumber;
+    }
+
+    /*!
+     * \brief The sequence number of the grid for which the geometry was determined.
+     *
+     * If update() has not yet been called, this is -1.
+     */
+    int sequenceNumber() const
+    { return sequenceNumber_; }
+
+    /*!
+     * \brief The number of elements for which the geometry is stored.
+     */
+    size_t numElements() const
+    { return cellVolume_.size(); }
+
+    /*!
+     * \brief Return an element given its index.
+     */
+    template <class Grid>
+    Element element(const Grid& grid, unsigned elemIdx) const
+    { return grid.entity(seeds_[elemIdx]); }
+
+    /*!
+     * \brief The volume [m^3] of an element.
+     */
+    Scalar cellVolume(unsigned elemIdx) const
+    { return cellVolume_[elemIdx]; }
+
+    /*!
+     * \brief The center of an element.
+     */
+    const GlobalPosition& cellCenter(unsigned elemIdx) const
+    { return cellCenter_[elemIdx]; }
+
+    /*!
+     * \brief The index of the first intersection of an element.
+     */
+    size_t faceBegin(unsigned elemIdx) const
+    { return faceOffsets_[elemIdx]; }
+
+    /*!
+     * \brief The index after the last intersection of an element.
+     */
+    size_t faceEnd(unsigned elemIdx) const
+    { return faceOffsets_[elemIdx + 1]; }
+
+    /*!
+     * \brief The index of the element on the outside of an intersection.
+     *
+     * If the intersection does not have a neighbor, -1 is returned.
+     */
+    int faceNeighbor(size_t faceIdx) const
+    { return faceNeighbor_[faceIdx]; }
+
+    /*!
+     * \brief The area [m^2] of an intersection.
+     */
+    Scalar faceArea(size_t faceIdx) const
+    { return faceArea_[faceIdx]; }
+
+    /*!
+     * \brief The outer unit normal at the center of an intersection.
+     */
+    const WorldVector& faceNormal(size_t faceIdx) const
+    { return faceNormal_[faceIdx]; }
+
+    /*!
+     * \brief The center of an intersection.
+     */
+    const GlobalPosition& faceCenter(size_t faceIdx) const
+    { return faceCenter_[faceIdx]; }
+
+    /*!
+     * \brief The number of bytes occupied by the stored geometry.
+     */
+    size_t memoryUsage() const
+    {
+        return
+            seeds_.capacity()*sizeof(EntitySeed)
+            + cellVolume_.capacity()*sizeof(Scalar)
+            + cellCenter_.capacity()*sizeof(GlobalPosition)
+            + faceOffsets_.capacity()*sizeof(size_t)
+            + faceNeighbor_.capacity()*sizeof(int)
+            + faceArea_.capacity()*sizeof(Scalar)
+            + faceNormal_.capacity()*sizeof(WorldVector)
+            + faceCenter_.capacity()*sizeof(GlobalPosition);
+    }
+
+private:
+    int sequenceNumber_;
+
+    std::vector<EntitySeed> seeds_;
+    std::vector<Scalar> cellVolume_;
+    std::vector<GlobalPosition> cellCenter_;
+
+    std::vector<size_t> faceOffsets_;
+    std::vector<int> faceNeighbor_;
+    std::vector<Scalar> faceArea_;
+    std::vector<WorldVector> faceNormal_;
+    std::vector<GlobalPosition> faceCenter_;
+};
+
+} // namespace Opm
+
+#endif
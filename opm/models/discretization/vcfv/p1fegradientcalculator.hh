@@ -89,6 +89,14 @@ class P1FeGradientCalculator : public FvBaseGradientCalculator<TypeTag>
 #endif // HAVE_DUNE_LOCALFUNCTIONS
 
 public:
+    /*!
+     * \copydoc FvBaseGradientCalculator::isFaceLocal()
+     *
+     * P1 finite element gradients depend on all vertices of the element.
+     */
+    static constexpr bool isFaceLocal()
+    { return !getPropValue<TypeTag, Properties::UseP1FiniteElementGradients>(); }
+
     /*!
      * \brief Precomputes the common values to calculate gradients and
      *        values of quantities at any flux approximation point.
@@ -32,6 +32,7 @@
 
 #include "vcfvproperties.hh"
 #include "vcfvstencil.hh"
+#include "vcfvstencilgeometry.hh"
 #include "p1fegradientcalculator.hh"
 #include "vcfvgridcommhandlefactory.hh"
 #include "vcfvbaseoutputmodule.hh"
@@ -445,6 +445,9 @@ VcfvScvGeometries<Scalar, /*dim=*/3, ElementType::cube>::scvGeoms_[
  * \endcond
  */
 
+template <class Scalar, class GridView>
+class VcfvStencilGeometry;
+
 /*!
  * \ingroup VcfvDiscretization
  *
@@ -463,10 +466,15 @@ VcfvScvGeometries<Scalar, /*dim=*/3, ElementType::cube>::scvGeoms_[
  * For the vertex-cented finite volume method the sub-control volumes
  * are constructed by connecting the element's center with each edge
  * of the element.
+ *
+ * If a VcfvStencilGeometry object is attached to the stencil via setGeometry(), the
+ * geometry of the stencil is copied from it instead of being computed.
  */
 template <class Scalar, class GridView>
 class VcfvStencil
 {
+    friend class VcfvStencilGeometry<Scalar, GridView>;
+
     enum{dim = GridView::dimension};
     enum{dimWorld = GridView::dimensionworld};
     enum{maxNC = (dim < 3 ? 4 : 8)};
@@ -726,6 +734,9 @@ public:
     //! exported Mapper type
     using Mapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
 
+    //! the type of the pre-computed geometry of the stencils
+    using StencilGeometry = VcfvStencilGeometry<Scalar, GridView>;
+
     class ScvGeometry
     {
     public:
@@ -814,6 +825,7 @@ public:
         : gridView_(gridView)
         , vertexMapper_(mapper )
         , element_(*gridView.template begin</*codim=*/0>())
+        , geometry_(nullptr)
     {
         // try to check if the mapper really maps the vertices
         assert(static_cast<int>(gridView.size(/*codim=*/dimWorld)) == static_cast<int>(mapper.size()));
@@ -830,6 +842,15 @@ public:
         }
     }
 
+    /*!
+     * \brief Use the pre-computed geometry of the stencils.
+     *
+     * The object must have been updated for the current grid. If nullptr is passed, the
+     * geometry is computed for each element.
+     */
+    void setGeometry(const StencilGeometry* geometry)
+    { geometry_ = geometry; }
+
     /*!
      * \brief Update the non-geometric part of the stencil.
      *
@@ -837,6 +858,11 @@ public:
      */
     void updateTopology(const Element& e)
     {
+        if (geometry_) {
+            geometry_->restoreTopology(*this, e);
+            return;
+        }
+
         element_ = e;
 
         numVertices = e.subEntities(/*codim=*/dim);
@@ -865,6 +891,12 @@ public:
 
     void update(const Element& e)
     {
+        if (geometry_) {
+            geometry_->restore(*this, e);
+            updateScvGeometry(e);
+            return;
+        }
+
         updateTopology(e);
 
         const Geometry& geometry = e.geometry();
@@ -1349,6 +1381,7 @@ private:
     const Mapper& vertexMapper_;
 
     Element element_;
+    const StencilGeometry* geometry_;
 
 #if HAVE_DUNE_LOCALFUNCTIONS
     static LocalFiniteElementCache feCache_;
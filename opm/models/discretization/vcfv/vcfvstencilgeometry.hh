@@ -0,0 +1,257 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::VcfvStencilGeometry
+ */
+#ifndef EWOMS_VCFV_STENCIL_GEOMETRY_HH
+#define EWOMS_VCFV_STENCIL_GEOMETRY_HH
+
+#include "vcfvstencil.hh"
+
+#include <dune/grid/common/mcmgmapper.hh>
+#include <dune/common/fvector.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Opm {
+/*!
+ * \ingroup VcfvDiscretization
+ *
+ * \brief Stores the geometry of the VCFV stencils of all elements of a grid view.
+ *
+ * For each element, the stencil is updated once and the results are copied into flat
+ * arrays: the volume and the center of the element, the positions and the volumes of
+ * its sub-control volumes as well as the complete data of its interior and boundary
+ * sub-control volume faces (integration points, normals and areas). Afterwards,
+ * VcfvStencil::update() only needs to copy these values back instead of computing the
+ * sub-control volume geometries, the normals and the areas from scratch.
+ *
+ * Since building these arrays requires a sequential iteration over the grid, the
+ * sequence number of the grid for which they were built is stored to detect grid
+ * modifications.
+ */
+template <class Scalar, class GridView>
+class VcfvStencilGeometry
+{
+    enum { dim = GridView::dimension };
+    enum { dimWorld = GridView::dimensionworld };
+
+    using CoordScalar = typename GridView::ctype;
+    using Element = typename GridView::template Codim<0>::Entity;
+    using ElementIterator = typename GridView::template Codim<0>::Iterator;
+    using ElementMapper = Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
+
+    using Stencil = VcfvStencil<Scalar, GridView>;
+    using SubControlVolumeFace = typename Stencil::SubControlVolumeFace;
+    using BoundaryFace = typename Stencil::BoundaryFace;
+    using VertexMapper = typename Stencil::Mapper;
+
+    using GlobalPosition = Dune::FieldVector<CoordScalar, dimWorld>;
+    using LocalPosition = Dune::FieldVector<CoordScalar, dim>;
+
+    // the data stored for each element. The sub-control volumes, interior faces and
+    // boundary faces of an element are stored consecutively in the respective arrays.
+    struct ElementData_
+    {
+        GlobalPosition global;
+        LocalPosition local;
+        Scalar volume;
+        unsigned scvBegin;
+        unsigned faceBegin;
+        unsigned boundaryFaceBegin;
+        unsigned char numVertices;
+        unsigned char numEdges;
+        unsigned char numFaces;
+        unsigned char numBoundaryFaces;
+    };
+
+    struct ScvData_
+    {
+        GlobalPosition global;
+        LocalPosition local;
+        Scalar volume;
+    };
+
+public:
+    VcfvStencilGeometry()
+        : sequenceNumber_(-1)
+        , elementMapper_(nullptr)
+    { }
+
+    /*!
+     * \brief Determine the geometry of the stencils of all elements of a grid view.
+     *
+     * \param gridView The grid view for which the geometry is determined
+     * \param elementMapper The mapper from the elements to their indices. This object
+     *                      must stay alive as long as the geometry is used.
+     * \param vertexMapper The mapper from the vertices to their indices
+     * \param sequenceNumber The sequence number of the grid
+     */
+    void update(const GridView& gridView,
+                const ElementMapper& elementMapper,
+                const VertexMapper& vertexMapper,
+                int sequenceNumber)
+    {
+        elementMapper_ = &elementMapper;
+
+        elementData_.resize(static_cast<size_t>(gridView.size(/*codim=*/0)));
+        scvData_.clear();
+        faces_.clear();
+        boundaryFaces_.clear();
+
+        Stencil stencil(gridView, vertexMapper);
+        ElementIterator elemIt = gridView.template begin</*codim=*/0>();
+        const ElementIterator& elemEndIt = gridView.template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            stencil.update(elem);
+
+            ElementData_& data = elementData_[elementMapper.index(elem)];
+            data.global = stencil.elementGlobal;
+            data.local = stencil.elementLocal;
+            data.volume = stencil.elementVolume;
+            data.scvBegin = static_cast<unsigned>(scvData_.size());
+            data.faceBegin = static_cast<unsigned>(faces_.size());
+            data.boundaryFaceBegin = static_cast<unsigned>(boundaryFaces_.size());
+            data.numVertices = static_cast<unsigned char>(stencil.numVertices);
+            data.numEdges = static_cast<unsigned char>(stencil.numEdges);
+            data.numFaces = static_cast<unsigned char>(stencil.numFaces);
+            data.numBoundaryFaces = static_cast<unsigned char>(stencil.numBoundarySegments_);
+
+            for (unsigned scvIdx = 0; scvIdx < stencil.numVertices; ++scvIdx) {
+                const auto& scv = stencil.subContVol[scvIdx];
+                scvData_.push_back(ScvData_{scv.global, scv.local, scv.volume_});
+            }
+            for (unsigned faceIdx = 0; faceIdx < stencil.numEdges; ++faceIdx)
+                faces_.push_back(stencil.subContVolFace[faceIdx]);
+            for (unsigned bfIdx = 0; bfIdx < stencil.numBoundarySegments_; ++bfIdx)
+                boundaryFaces_.push_back(stencil.boundaryFace_[bfIdx]);
+        }
+
+        scvData_.shrink_to_fit();
+        faces_.shrink_to_fit();
+        boundaryFaces_.shrink_to_fit();
+
+        sequenceNumber_ = sequenceNumber;
+    }
+
+    /*!
+     * \brief The sequence number of the grid for which the geometry was determined.
+     *
+     * If update() has not yet been called, this is -1.
+     */
+    int sequenceNumber() const
+    { return sequenceNumber_; }
+
+    /*!
+     * \brief The number of elements for which the geometry is stored.
+     */
+    size_t numElements() const
+    { return elementData_.size(); }
+
+    /*!
+     * \brief The number of bytes occupied by the stored geometry.
+     */
+    size_t memoryUsage() const
+    {
+        return
+            elementData_.capacity()*sizeof(ElementData_)
+            + scvData_.capacity()*sizeof(ScvData_)
+            + faces_.capacity()*sizeof(SubControlVolumeFace)
+            + boundaryFaces_.capacity()*sizeof(BoundaryFace);
+    }
+
+    /*!
+     * \brief Set the topological part of a stencil, i.e., the result of
+     *        VcfvStencil::updateTopology().
+     */
+    void restoreTopology(Stencil& stencil, const Element& elem) const
+    {
+        const ElementData_& data = elementData_[elementMapper_->index(elem)];
+
+        stencil.element_ = elem;
+        stencil.geometryType_ = elem.type();
+        stencil.numVertices = data.numVertices;
+        stencil.numEdges = data.numEdges;
+        stencil.numFaces = data.numFaces;
+        stencil.numBoundarySegments_ = 0;
+
+        const ScvData_* scvData = &scvData_[data.scvBegin];
+        for (unsigned scvIdx = 0; scvIdx < data.numVertices; ++scvIdx) {
+            stencil.subContVol[scvIdx].local = scvData[scvIdx].local;
+            stencil.subContVol[scvIdx].global = scvData[scvIdx].global;
+        }
+    }
+
+    /*!
+     * \brief Set the complete geometry of a stencil, i.e., the result of
+     *        VcfvStencil::update().
+     */
+    void restore(Stencil& stencil, const Element& elem) const
+    {
+        const ElementData_& data = elementData_[elementMapper_->index(elem)];
+
+        stencil.element_ = elem;
+        stencil.geometryType_ = elem.type();
+        stencil.numVertices = data.numVertices;
+        stencil.numEdges = data.numEdges;
+        stencil.numFaces = data.numFaces;
+        stencil.numBoundarySegments_ = data.numBoundaryFaces;
+
+        stencil.elementGlobal = data.global;
+        stencil.elementLocal = data.local;
+        stencil.elementVolume = data.volume;
+
+        const ScvData_* scvData = &scvData_[data.scvBegin];
+        for (unsigned scvIdx = 0; scvIdx < data.numVertices; ++scvIdx) {
+            auto& scv = stencil.subContVol[scvIdx];
+            scv.local = scvData[scvIdx].local;
+            scv.global = scvData[scvIdx].global;
+            scv.volume_ = scvData[scvIdx].volume;
+        }
+
+        std::copy(faces_.begin() + data.faceBegin,
+                  faces_.begin() + data.faceBegin + data.numEdges,
+                  stencil.subContVolFace);
+        std::copy(boundaryFaces_.begin() + data.boundaryFaceBegin,
+                  boundaryFaces_.begin() + data.boundaryFaceBegin + data.numBoundaryFaces,
+                  stencil.boundaryFace_);
+    }
+
+private:
+    int sequenceNumber_;
+    const ElementMapper* elementMapper_;
+
+    std::vector<ElementData_> elementData_;
+    std::vector<ScvData_> scvData_;
+    std::vector<SubControlVolumeFace> faces_;
+    std::vector<BoundaryFace> boundaryFaces_;
+};
+
+} // namespace Opm
+
+#endif
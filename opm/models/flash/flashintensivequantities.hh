@@ -113,15 +113,11 @@ public:
         for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
             cTotal[compIdx] = priVars.makeEvaluation(cTot0Idx + compIdx, timeIdx);
 
-        const auto *hint = elemCtx.thermodynamicHint(dofIdx, timeIdx);
-        if (hint) {
-            // use the same fluid state as the one of the hint, but
-            // make sure that we don't overwrite the temperature
-            // specified by the primary variables
-            Evaluation T = fluidState_.temperature(/*phaseIdx=*/0);
-            fluidState_.assign(hint->fluidState());
-            fluidState_.setTemperature(T);
-        }
+        const auto hint = elemCtx.thermodynamicHint(dofIdx, timeIdx);
+        if (hint)
+            // start with the pressures, saturations and compositions of the hint. the
+            // temperature is the one specified by the primary variables
+            hint.assignTo(fluidState_);
         else
             FlashSolver::guessInitial(fluidState_, cTotal);
 
@@ -0,0 +1,627 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::BinaryRestart
+ */
+#ifndef EWOMS_BINARY_RESTART_HH
+#define EWOMS_BINARY_RESTART_HH
+
+#include "restart.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Opm {
+
+/*!
+ * \brief Load or save a state of a problem to/from the harddisk using a binary file
+ *        format.
+ *
+ * The interface is the same as the one of Opm::Restart, i.e., the serialize() and
+ * deserialize() methods of the simulator, the problem and the model work with both
+ * formats. A binary restart file looks like this:
+ *
+ * - A fixed size header consisting of a magic string, the format version, some flags,
+ *   the number of sections and the position of the section index.
+ * - The payload of all sections, one after the other.
+ * - The section index which stores the name, the position, the size and (optionally) a
+ *   checksum of each section.
+ *
+ * Sections for grid entities store one record per entity which is prefixed by its size.
+ * Code which serializes entities can check whether it writes to a binary restart file
+ * using BinaryRestart::isBinary() and write raw data instead of text in this case.
+ * Everything else which is written to the serialization streams is stored verbatim.
+ *
+ * For reading, the file is mapped into memory and the deserialization stream directly
+ * operates on the mapped pages, i.e., the file contents are not copied.
+ */
+class BinaryRestart
+{
+    static constexpr char magic_[8] = { 'O', 'P', 'M', 'R', 'S', 'T', 'B', '\0' };
+    static constexpr uint32_t version_ = 1;
+    static constexpr uint32_t checksumFlag_ = 1;
+
+    struct Header_
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t flags;
+        uint64_t numSections;
+        uint64_t indexOffset;
+    };
+
+    struct Section_
+    {
+        std::string name;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t checksum;
+    };
+
+    // a stream buffer which writes into a growing piece of memory
+    class OutBuffer_ : public std::streambuf
+    {
+    public:
+        OutBuffer_()
+        { clear(); }
+
+        void clear()
+        {
+            data_.resize(4096);
+            setp(data_.data(), data_.data() + data_.size());
+        }
+
+        const char* data() const
+        { return pbase(); }
+
+        size_t size() const
+        { return static_cast<size_t>(pptr() - pbase()); }
+
+        // overwrite some bytes which have already been written
+        void patch(size_t pos, const void* src, size_t n)
+        {
+            assert(pos + n <= size());
+            std::memcpy(data_.data() + pos, src, n);
+        }
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            reserve_(size() + 1);
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            reserve_(size() + static_cast<size_t>(n));
+            std::memcpy(pptr(), s, static_cast<size_t>(n));
+            advance_(static_cast<size_t>(n));
+            return n;
+        }
+
+    private:
+        void reserve_(size_t n)
+        {
+            if (n <= data_.size())
+                return;
+
+            size_t used = size();
+            data_.resize(std::max(n, 2*data_.size()));
+            setp(data_.data(), data_.data() + data_.size());
+            advance_(used);
+        }
+
+        // pbump() only accepts int
+        void advance_(size_t n)
+        {
+            while (n > 0) {
+                int k = static_cast<int>(std::min<size_t>(n, 1 << 30));
+                pbump(k);
+                n -= static_cast<size_t>(k);
+            }
+        }
+
+        std::vector<char> data_;
+    };
+
+    // a stream buffer which reads from a given piece of memory without copying it
+    class InBuffer_ : public std::streambuf
+    {
+    public:
+        void reset(const char* begin, const char* end)
+        {
+            // std::streambuf never writes to the get area, so casting away the
+            // constness is okay
+            char* b = const_cast<char*>(begin);
+            char* e = const_cast<char*>(end);
+            setg(b, b, e);
+        }
+
+        const char* pos() const
+        { return gptr(); }
+
+        const char* end() const
+        { return egptr(); }
+    };
+
+public:
+    /*!
+     * \brief Create a binary restarter.
+     *
+     * \param enableChecksum If true, a checksum is stored for each section when writing
+     *                       and it is verified when reading.
+     */
+    explicit BinaryRestart(bool enableChecksum = true)
+        : enableChecksum_(enableChecksum)
+        , checksumEnabledInFile_(false)
+        , staging_(false)
+        , outStream_(&outBuffer_)
+        , inStream_(&inBuffer_)
+        , mappedData_(nullptr)
+        , mappedSize_(0)
+        , sectionEnd_(nullptr)
+        , nextSectionIdx_(0)
+    {
+        outStream_.precision(20);
+        outStream_.iword(binaryStreamIndex_()) = 1;
+        inStream_.iword(binaryStreamIndex_()) = 1;
+    }
+
+    BinaryRestart(const BinaryRestart&) = delete;
+
+    ~BinaryRestart()
+    { unmap_(); }
+
+    /*!
+     * \brief Returns true if a stream belongs to a binary restart file.
+     *
+     * The serialization methods of entities can use this to decide whether to write
+     * raw data or text.
+     */
+    static bool isBinary(std::ios_base& stream)
+    { return stream.iword(binaryStreamIndex_()) != 0; }
+
+    /*!
+     * \copydoc Restart::enableStaging()
+     */
+    void enableStaging()
+    { staging_ = true; }
+
+    /*!
+     * \copydoc Restart::stagedData()
+     */
+    std::string stagedData() const
+    { return stagingStream_.str(); }
+
+    /*!
+     * \brief Returns the name of the file which is (de-)serialized.
+     */
+    const std::string& fileName() const
+    { return fileName_; }
+
+    /*!
+     * \brief Write the current state of the model to disk.
+     */
+    template <class Simulator>
+    void serializeBegin(Simulator& simulator)
+    {
+        const std::string magicCookie = Restart::magicRestartCookie_(simulator.gridView());
+        fileName_ = Restart::restartFileName_(simulator.gridView(),
+                                              simulator.problem().outputDir(),
+                                              simulator.problem().name(),
+                                              simulator.time(),
+                                              ".erb");
+
+        if (staging_)
+            stagingStream_.str("");
+        else
+            fileStream_.open(fileName_.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out_().good())
+            throw std::runtime_error("Restart file '"+fileName_+"' could not be opened properly");
+
+        // the header is written again with the correct values by serializeEnd()
+        sections_.clear();
+        writeHeader_();
+
+        serializeSectionBegin(magicCookie);
+        serializeSectionEnd();
+    }
+
+    /*!
+     * \brief The output stream to write the serialized data.
+     */
+    std::ostream& serializeStream()
+    { return outStream_; }
+
+    /*!
+     * \brief Start a new section in the serialized output.
+     */
+    void serializeSectionBegin(const std::string& cookie)
+    {
+        curSectionName_ = cookie;
+        outBuffer_.clear();
+        outStream_.clear();
+    }
+
+    /*!
+     * \brief End of a section in the serialized output.
+     */
+    void serializeSectionEnd()
+    {
+        Section_ section;
+        section.name = curSectionName_;
+        section.offset = static_cast<uint64_t>(out_().tellp());
+        section.size = outBuffer_.size();
+        section.checksum = enableChecksum_ ? checksum_(outBuffer_.data(), outBuffer_.size()) : 0;
+
+        out_().write(outBuffer_.data(), static_cast<std::streamsize>(outBuffer_.size()));
+        if (!out_().good())
+            throw std::runtime_error("Could not write section '"+curSectionName_+"' "
+                                     "to restart file '"+fileName_+"'");
+
+        sections_.push_back(section);
+        outBuffer_.clear();
+    }
+
+    /*!
+     * \brief Serialize all leaf entities of a codim in a gridView.
+     *
+     * The actual work is done by Serializer::serialize(Entity)
+     */
+    template <int codim, class Serializer, class GridView>
+    void serializeEntities(Serializer& serializer, const GridView& gridView)
+    {
+        std::ostringstream oss;
+        oss << "Entities: Codim " << codim;
+        std::string cookie = oss.str();
+        serializeSectionBegin(cookie);
+
+        uint64_t numEntities = static_cast<uint64_t>(gridView.size(codim));
+        outStream_.write(reinterpret_cast<const char*>(&numEntities), sizeof(numEntities));
+
+        // write element data. each entity gets a record which is prefixed by its size
+        using Iterator = typename GridView::template Codim<codim>::Iterator;
+
+        Iterator it = gridView.template begin<codim>();
+        const Iterator& endIt = gridView.template end<codim>();
+        for (; it != endIt; ++it) {
+            uint32_t recordSize = 0;
+            size_t recordPos = outBuffer_.size();
+            outStream_.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+
+            serializer.serializeEntity(outStream_, *it);
+
+            recordSize = static_cast<uint32_t>(outBuffer_.size() - recordPos - sizeof(recordSize));
+            outBuffer_.patch(recordPos, &recordSize, sizeof(recordSize));
+        }
+
+        serializeSectionEnd();
+    }
+
+    /*!
+     * \brief Finish the restart file.
+     */
+    void serializeEnd()
+    {
+        uint64_t indexOffset = static_cast<uint64_t>(out_().tellp());
+        for (const auto& section : sections_) {
+            uint32_t nameLength = static_cast<uint32_t>(section.name.size());
+            writeRaw_(nameLength);
+            out_().write(section.name.data(), nameLength);
+            writeRaw_(section.offset);
+            writeRaw_(section.size);
+            writeRaw_(section.checksum);
+        }
+
+        out_().seekp(0);
+        writeHeader_(indexOffset);
+
+        if (!out_().good())
+            throw std::runtime_error("Could not write restart file '"+fileName_+"'");
+        if (!staging_)
+            fileStream_.close();
+    }
+
+    /*!
+     * \brief Start reading a restart file at a certain simulated
+     *        time.
+     */
+    template <class Simulator, class Scalar>
+    void deserializeBegin(Simulator& simulator, Scalar t)
+    {
+        fileName_ = Restart::restartFileName_(simulator.gridView(),
+                                              simulator.problem().outputDir(),
+                                              simulator.problem().name(),
+                                              t,
+                                              ".erb");
+        map_();
+        readIndex_();
+
+        const std::string magicCookie = Restart::magicRestartCookie_(simulator.gridView());
+
+        deserializeSectionBegin(magicCookie);
+        deserializeSectionEnd();
+    }
+
+    /*!
+     * \brief The input stream to read the data which ought to be
+     *        deserialized.
+     */
+    std::istream& deserializeStream()
+    { return inStream_; }
+
+    /*!
+     * \brief Start reading a new section of the restart file.
+     */
+    void deserializeSectionBegin(const std::string& cookie)
+    {
+        if (nextSectionIdx_ >= sections_.size())
+            throw std::runtime_error("Encountered unexpected EOF in restart file.");
+
+        const Section_& section = sections_[nextSectionIdx_++];
+        if (section.name != cookie)
+            throw std::runtime_error("Could not start section '"+cookie+"'");
+
+        const char* begin = mappedData_ + section.offset;
+        if (enableChecksum_ && checksumEnabledInFile_
+            && checksum_(begin, section.size) != section.checksum)
+            throw std::runtime_error("Checksum mismatch for section '"+cookie+"' "
+                                     "of restart file '"+fileName_+"'");
+
+        sectionEnd_ = begin + section.size;
+        inBuffer_.reset(begin, sectionEnd_);
+        inStream_.clear();
+    }
+
+    /*!
+     * \brief End of a section in the serialized output.
+     */
+    void deserializeSectionEnd()
+    { checkConsumed_(); }
+
+    /*!
+     * \brief Deserialize all leaf entities of a codim in a grid.
+     *
+     * The actual work is done by Deserializer::deserialize(Entity)
+     */
+    template <int codim, class Deserializer, class GridView>
+    void deserializeEntities(Deserializer& deserializer, const GridView& gridView)
+    {
+        std::ostringstream oss;
+        oss << "Entities: Codim " << codim;
+        std::string cookie = oss.str();
+        deserializeSectionBegin(cookie);
+
+        const char* pos = inBuffer_.pos();
+        uint64_t numEntities;
+        readRaw_(pos, numEntities);
+        if (numEntities != static_cast<uint64_t>(gridView.size(codim)))
+            throw std::runtime_error("Restart file is corrupted");
+
+        // read entity data
+        using Iterator = typename GridView::template Codim<codim>::Iterator;
+        Iterator it = gridView.template begin<codim>();
+        const Iterator& endIt = gridView.template end<codim>();
+        for (; it != endIt; ++it) {
+            uint32_t recordSize;
+            readRaw_(pos, recordSize);
+            if (pos + recordSize > sectionEnd_)
+                throw std::runtime_error("Restart file is corrupted");
+
+            inBuffer_.reset(pos, pos + recordSize);
+            inStream_.clear();
+            deserializer.deserializeEntity(inStream_, *it);
+            checkConsumed_();
+
+            pos += recordSize;
+        }
+
+        inBuffer_.reset(pos, sectionEnd_);
+        inStream_.clear();
+        deserializeSectionEnd();
+    }
+
+    /*!
+     * \brief Stop reading the restart file.
+     */
+    void deserializeEnd()
+    {
+        unmap_();
+        sections_.clear();
+        nextSectionIdx_ = 0;
+    }
+
+private:
+    std::ostream& out_()
+    {
+        if (staging_)
+            return stagingStream_;
+        return fileStream_;
+    }
+
+    static int binaryStreamIndex_()
+    {
+        static const int idx = std::ios_base::xalloc();
+        return idx;
+    }
+
+    // 64 bit FNV-1a hash
+    static uint64_t checksum_(const char* data, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    template <class T>
+    void writeRaw_(const T& value)
+    { out_().write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+
+    template <class T>
+    void readRaw_(const char*& pos, T& value) const
+    {
+        if (pos + sizeof(value) > sectionEnd_)
+            throw std::runtime_error("Restart file is corrupted");
+        std::memcpy(&value, pos, sizeof(value));
+        pos += sizeof(value);
+    }
+
+    void writeHeader_(uint64_t indexOffset = 0)
+    {
+        Header_ header;
+        std::memcpy(header.magic, magic_, sizeof(magic_));
+        header.version = version_;
+        header.flags = enableChecksum_ ? checksumFlag_ : 0;
+        header.numSections = sections_.size();
+        header.indexOffset = indexOffset;
+        out_().write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    void map_()
+    {
+        int fd = ::open(fileName_.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Restart file '"+fileName_+"' could not be opened properly");
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("Restart file '"+fileName_+"' is empty");
+        }
+
+        mappedSize_ = static_cast<size_t>(st.st_size);
+        void* addr = ::mmap(nullptr, mappedSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping stays valid after the file descriptor has been closed
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            mappedSize_ = 0;
+            throw std::runtime_error("Restart file '"+fileName_+"' could not be mapped");
+        }
+
+        mappedData_ = static_cast<const char*>(addr);
+    }
+
+    void unmap_()
+    {
+        if (mappedData_)
+            ::munmap(const_cast<char*>(mappedData_), mappedSize_);
+        mappedData_ = nullptr;
+        mappedSize_ = 0;
+    }
+
+    void readIndex_()
+    {
+        const char* fileEnd = mappedData_ + mappedSize_;
+        Header_ header;
+        if (mappedSize_ < sizeof(header))
+            throw std::runtime_error("Restart file '"+fileName_+"' is corrupted");
+        std::memcpy(&header, mappedData_, sizeof(header));
+        if (std::memcmp(header.magic, magic_, sizeof(magic_)) != 0
+            || header.version != version_)
+            throw std::runtime_error("File '"+fileName_+"' is not a binary restart file "
+                                     "of a supported version");
+        checksumEnabledInFile_ = (header.flags & checksumFlag_) != 0;
+
+        sections_.clear();
+        nextSectionIdx_ = 0;
+        sectionEnd_ = fileEnd;
+        if (header.indexOffset > mappedSize_)
+            throw std::runtime_error("Restart file '"+fileName_+"' is corrupted");
+        const char* pos = mappedData_ + header.indexOffset;
+        for (uint64_t sectionIdx = 0; sectionIdx < header.numSections; ++sectionIdx) {
+            Section_ section;
+            uint32_t nameLength;
+            readRaw_(pos, nameLength);
+            if (pos + nameLength > fileEnd)
+                throw std::runtime_error("Restart file '"+fileName_+"' is corrupted");
+            section.name.assign(pos, nameLength);
+            pos += nameLength;
+            readRaw_(pos, section.offset);
+            readRaw_(pos, section.size);
+            readRaw_(pos, section.checksum);
+
+            if (section.offset + section.size > header.indexOffset)
+                throw std::runtime_error("Restart file '"+fileName_+"' is corrupted");
+            sections_.push_back(section);
+        }
+    }
+
+    // make sure that only whitespace is left in the current get area
+    void checkConsumed_()
+    {
+        for (const char* c = inBuffer_.pos(); c != inBuffer_.end(); ++c) {
+            if (!std::isspace(static_cast<unsigned char>(*c))) {
+                throw std::logic_error("Encountered unread values while deserializing");
+            }
+        }
+    }
+
+    bool enableChecksum_;
+    bool checksumEnabledInFile_;
+    std::string fileName_;
+
+    // writing
+    bool staging_;
+    std::ofstream fileStream_;
+    std::ostringstream stagingStream_;
+    OutBuffer_ outBuffer_;
+    std::ostream outStream_;
+    std::string curSectionName_;
+
+    // reading
+    InBuffer_ inBuffer_;
+    std::istream inStream_;
+    const char* mappedData_;
+    size_t mappedSize_;
+    const char* sectionEnd_;
+    size_t nextSectionIdx_;
+
+    std::vector<Section_> sections_;
+};
+} // namespace Opm
+
+#endif
@@ -34,11 +34,16 @@
 
 namespace Opm {
 
+class BinaryRestart;
+
 /*!
  * \brief Load or save a state of a problem to/from the harddisk.
  */
 class Restart
 {
+    // the binary format uses the same file names and magic cookies
+    friend class BinaryRestart;
+
     /*!
      * \brief Create a magic cookie for restart files, so that it is
      *        unlikely to load a restart file for an incorrectly.
@@ -73,7 +78,8 @@ class Restart
     static const std::string restartFileName_(const GridView& gridView,
                                               const std::string& outputDir,
                                               const std::string& simName,
-                                              Scalar t)
+                                              Scalar t,
+                                              const std::string& extension = ".ers")
     {
         std::string dir = outputDir;
         if (dir == ".")
@@ -83,11 +89,32 @@ class Restart
 
         int rank = gridView.comm().rank();
         std::ostringstream oss;
-        oss << dir << simName << "_time=" << t << "_rank=" << rank << ".ers";
+        oss << dir << simName << "_time=" << t << "_rank=" << rank << extension;
         return oss.str();
     }
 
 public:
+    Restart()
+        : staging_(false)
+    { }
+
+    /*!
+     * \brief Keep the serialized data in memory instead of writing it to the restart
+     *        file.
+     *
+     * This must be called before serializeBegin(). After serializeEnd(), the contents
+     * of the restart file can be retrieved using stagedData(). Writing them to
+     * fileName() is then up to the caller.
+     */
+    void enableStaging()
+    { staging_ = true; }
+
+    /*!
+     * \brief Returns the serialized data if staging is enabled.
+     */
+    std::string stagedData() const
+    { return stagingStream_.str(); }
+
     /*!
      * \brief Returns the name of the file which is (de-)serialized.
      */
@@ -107,8 +134,11 @@ public:
                                      simulator.time());
 
         // open output file and write magic cookie
-        outStream_.open(fileName_.c_str());
-        outStream_.precision(20);
+        if (staging_)
+            stagingStream_.str("");
+        else
+            fileStream_.open(fileName_.c_str());
+        out_().precision(20);
 
         serializeSectionBegin(magicCookie);
         serializeSectionEnd();
@@ -118,19 +148,19 @@ public:
      * \brief The output stream to write the serialized data.
      */
     std::ostream& serializeStream()
-    { return outStream_; }
+    { return out_(); }
 
     /*!
      * \brief Start a new section in the serialized output.
      */
     void serializeSectionBegin(const std::string& cookie)
-    { outStream_ << cookie << "\n"; }
+    { out_() << cookie << "\n"; }
 
     /*!
      * \brief End of a section in the serialized output.
      */
     void serializeSectionEnd()
-    { outStream_ << "\n"; }
+    { out_() << "\n"; }
 
     /*!
      * \brief Serialize all leaf entities of a codim in a gridView.
@@ -151,8 +181,8 @@ public:
         Iterator it = gridView.template begin<codim>();
         const Iterator& endIt = gridView.template end<codim>();
         for (; it != endIt; ++it) {
-            serializer.serializeEntity(outStream_, *it);
-            outStream_ << "\n";
+            serializer.serializeEntity(out_(), *it);
+            out_() << "\n";
         }
 
         serializeSectionEnd();
@@ -162,7 +192,10 @@ public:
      * \brief Finish the restart file.
      */
     void serializeEnd()
-    { outStream_.close(); }
+    {
+        if (!staging_)
+            fileStream_.close();
+    }
 
     /*!
      * \brief Start reading a restart file at a certain simulated
@@ -266,9 +299,18 @@ public:
     { inStream_.close(); }
 
 private:
+    std::ostream& out_()
+    {
+        if (staging_)
+            return stagingStream_;
+        return fileStream_;
+    }
+
     std::string fileName_;
     std::ifstream inStream_;
-    std::ofstream outStream_;
+    std::ofstream fileStream_;
+    std::ostringstream stagingStream_;
+    bool staging_;
 };
 } // namespace Opm
 
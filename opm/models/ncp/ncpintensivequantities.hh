@@ -138,14 +138,13 @@ public:
             fug[compIdx] = priVars.makeEvaluation(fugacity0Idx + compIdx, timeIdx);
 
         // calculate phase compositions
-        const auto *hint = elemCtx.thermodynamicHint(dofIdx, timeIdx);
+        const auto hint = elemCtx.thermodynamicHint(dofIdx, timeIdx);
         for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
             // initial guess
             if (hint) {
                 for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
                     // use the hint for the initial mole fraction!
-                    const Evaluation& moleFracIJ = hint->fluidState().moleFraction(phaseIdx, compIdx);
-                    fluidState_.setMoleFraction(phaseIdx, compIdx, moleFracIJ);
+                    fluidState_.setMoleFraction(phaseIdx, compIdx, hint.moleFraction(phaseIdx, compIdx));
                 }
             }
             else // !hint
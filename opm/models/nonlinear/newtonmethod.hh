@@ -125,6 +125,24 @@ struct NewtonTargetIterations { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct NewtonMaxIterations { using type = UndefinedProperty; };
 
+/*!
+ * \brief The maximum number of consecutive Newton iterations which reuse the Jacobian
+ *        matrix of a previous iteration.
+ *
+ * In such an iteration, only the residual is evaluated and the linear system is solved
+ * using the Jacobian matrix and the preconditioner of the last full iteration. '0'
+ * disables this.
+ */
+template<class TypeTag, class MyTypeTag>
+struct NewtonMaxFrozenJacobianIterations { using type = UndefinedProperty; };
+
+/*!
+ * \brief The factor by which the error must have been reduced by the last Newton
+ *        iteration so that the Jacobian matrix may be reused by the next one.
+ */
+template<class TypeTag, class MyTypeTag>
+struct NewtonFrozenJacobianMaxErrorRatio { using type = UndefinedProperty; };
+
 // set default values for the properties
 template<class TypeTag>
 struct NewtonMethod<TypeTag, TTag::NewtonMethod> { using type = Opm::NewtonMethod<TypeTag>; };
@@ -152,6 +170,14 @@ template<class TypeTag>
 struct NewtonTargetIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 10; };
 template<class TypeTag>
 struct NewtonMaxIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 18; };
+template<class TypeTag>
+struct NewtonMaxFrozenJacobianIterations<TypeTag, TTag::NewtonMethod> { static constexpr int value = 0; };
+template<class TypeTag>
+struct NewtonFrozenJacobianMaxErrorRatio<TypeTag, TTag::NewtonMethod>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.5;
+};
 
 } // namespace Opm::Properties
 
@@ -197,6 +223,8 @@ public:
         tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonTolerance);
 
         numIterations_ = 0;
+        numFrozenJacobianIterations_ = 0;
+        errorReduction_ = 1.0;
     }
 
     /*!
@@ -225,6 +253,14 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonMaxError,
                              "The maximum error tolerated by the Newton "
                              "method to which does not cause an abort");
+        EWOMS_REGISTER_PARAM(TypeTag, int, NewtonMaxFrozenJacobianIterations,
+                             "The maximum number of consecutive Newton iterations "
+                             "which reuse the Jacobian matrix of an earlier "
+                             "iteration ('0' means 'never')");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonFrozenJacobianMaxErrorRatio,
+                             "The maximum ratio between the errors of two "
+                             "consecutive Newton iterations at which the Jacobian "
+                             "matrix is reused");
     }
 
     /*!
@@ -360,10 +396,20 @@ public:
                               << std::flush;
                 }
 
-                // do the actual linearization
+                // do the actual linearization. if the last iteration converged fast
+                // enough, only the residual is evaluated and the Jacobian matrix of an
+                // earlier iteration is reused
+                bool frozenJacobian = asImp_().useFrozenJacobian_();
                 linearizeTimer_.start();
-                asImp_().linearizeDomain_();
-                asImp_().linearizeAuxiliaryEquations_();
+                if (frozenJacobian) {
+                    asImp_().linearizeDomainResidual_();
+                    ++numFrozenJacobianIterations_;
+                }
+                else {
+                    asImp_().linearizeDomain_();
+                    asImp_().linearizeAuxiliaryEquations_();
+                    numFrozenJacobianIterations_ = 0;
+                }
                 linearizeTimer_.stop();
 
                 solveTimer_.start();
@@ -381,6 +427,11 @@ public:
                 asImp_().preSolve_(currentSolution, residual);
                 updateTimer_.stop();
 
+                if (numIterations_ > 0 && lastError_ > 0.0)
+                    errorReduction_ = error_/lastError_;
+                else
+                    errorReduction_ = 1.0;
+
                 if (!asImp_().proceed_()) {
                     if (asImp_().verbose_() && isatty(fileno(stdout)))
                         std::cout << clearRemainingLine
@@ -403,8 +454,10 @@ public:
 
                 solveTimer_.start();
                 // solve A x = b, where b is the residual, A is its Jacobian and x is the
-                // update of the solution
-                linearSolver_.setMatrix(jacobian);
+                // update of the solution. if the Jacobian matrix was not updated, the
+                // linear solver keeps the matrix and the preconditioner of the last solve.
+                if (!frozenJacobian)
+                    linearSolver_.setMatrix(jacobian);
                 solutionUpdate = 0.0;
                 bool converged = linearSolver_.solve(solutionUpdate);
                 solveTimer_.stop();
@@ -599,6 +652,8 @@ protected:
     void begin_(const SolutionVector& u  OPM_UNUSED)
     {
         numIterations_ = 0;
+        numFrozenJacobianIterations_ = 0;
+        errorReduction_ = 1.0;
 
         if (EWOMS_GET_PARAM(TypeTag, bool, NewtonWriteConvergence))
             convergenceWriter_.beginTimeStep();
@@ -647,6 +702,40 @@ protected:
         model().linearizer().finalize();
     }
 
+    /*!
+     * \brief Only evaluate the residual of the global non-linear system of equations
+     *        associated with the spatial domain.
+     *
+     * This is called instead of linearizeDomain_() and linearizeAuxiliaryEquations_()
+     * if the Jacobian matrix of an earlier iteration is reused.
+     */
+    void linearizeDomainResidual_()
+    {
+        model().linearizer().linearizeDomainResidual();
+    }
+
+    /*!
+     * \brief Returns true if the next iteration should reuse the Jacobian matrix of an
+     *        earlier one.
+     *
+     * This is the case if it is allowed by the NewtonMaxFrozenJacobianIterations
+     * parameter, if the Jacobian matrix has been fully assembled at least once during
+     * the current time step and if the last iteration reduced the error by at least
+     * the factor given by the NewtonFrozenJacobianMaxErrorRatio parameter. The
+     * equations of auxiliary modules always require a full linearization.
+     */
+    bool useFrozenJacobian_() const
+    {
+        int maxFrozenIterations = EWOMS_GET_PARAM(TypeTag, int, NewtonMaxFrozenJacobianIterations);
+        if (maxFrozenIterations <= 0
+            || numFrozenJacobianIterations_ >= maxFrozenIterations
+            || numIterations_ < 2
+            || model().numAuxiliaryModules() > 0)
+            return false;
+
+        return errorReduction_ <= EWOMS_GET_PARAM(TypeTag, Scalar, NewtonFrozenJacobianMaxErrorRatio);
+    }
+
     void preSolve_(const SolutionVector& currentSolution  OPM_UNUSED,
                    const GlobalEqVector& currentResidual)
     {
@@ -935,6 +1024,12 @@ protected:
     // actual number of iterations done so far
     int numIterations_;
 
+    // number of consecutive iterations which reused the Jacobian matrix
+    int numFrozenJacobianIterations_;
+
+    // ratio between the errors of the last and the second to last iteration
+    Scalar errorReduction_;
+
     // the linear solver
     LinearSolverBackend linearSolver_;
 
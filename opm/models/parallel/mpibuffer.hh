@@ -96,7 +96,26 @@ public:
     }
 
     /*!
-     * \brief Wait until the buffer was send to the peer completely.
+     * \brief Start receiving the buffer asyncronously from a peer rank.
+     *
+     * The data of the buffer is only valid after wait() has been called.
+     */
+    void startReceive(unsigned peerRank OPM_UNUSED_NOMPI)
+    {
+#if HAVE_MPI
+        MPI_Irecv(data_,
+                  static_cast<int>(mpiDataSize_),
+                  mpiDataType_,
+                  static_cast<int>(peerRank),
+                  0, // tag
+                  MPI_COMM_WORLD,
+                  &mpiRequest_);
+#endif
+    }
+
+    /*!
+     * \brief Wait until the buffer was send to the peer completely or, if
+     *        startReceive() was called, until it was received completely.
      */
     void wait()
     {
@@ -126,14 +145,14 @@ public:
     /*!
      * \brief Returns the current MPI_Request object.
      *
-     * This object is only well defined after the send() method.
+     * This object is only well defined after the send() and startReceive() methods.
      */
     MPI_Request& request()
     { return mpiRequest_; }
     /*!
      * \brief Returns the current MPI_Request object.
      *
-     * This object is only well defined after the send() method.
+     * This object is only well defined after the send() and startReceive() methods.
      */
     const MPI_Request& request() const
     { return mpiRequest_; }
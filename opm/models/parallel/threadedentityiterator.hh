@@ -27,15 +27,112 @@
 #ifndef EWOMS_THREADED_ENTITY_ITERATOR_HH
 #define EWOMS_THREADED_ENTITY_ITERATOR_HH
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <mutex>
+#include <vector>
 
 namespace Opm {
 
+/*!
+ * \brief Splits the entities of a GridView into chunks of consecutive entities which can
+ *        be distributed to threads by a ThreadedEntityIterator.
+ *
+ * Determining the chunks requires a sequential iteration over the grid, so objects of this
+ * class are supposed to be kept alive as long as the grid is not modified. To detect
+ * grid modifications, the sequence number of the grid for which the chunks were
+ * determined is stored.
+ */
+template <class GridView, int codim>
+class ThreadedEntityChunks
+{
+    using EntityIterator = typename GridView::template Codim<codim>::Iterator;
+
+public:
+    ThreadedEntityChunks()
+        : sequenceNumber_(-1)
+        , chunkSize_(1)
+        , numEntities_(0)
+    { }
+
+    /*!
+     * \brief Determine the chunks for a grid view.
+     *
+     * \param gridView The grid view for which the chunks are determined
+     * \param chunkSize The maximum number of entities per chunk
+     * \param sequenceNumber The sequence number of the grid
+     */
+    void update(const GridView& gridView, unsigned chunkSize, int sequenceNumber)
+    {
+        chunkSize_ = std::max(chunkSize, 1u);
+        numEntities_ = 0;
+        chunkBegin_.clear();
+
+        auto it = gridView.template begin<codim>();
+        const auto& endIt = gridView.template end<codim>();
+        for (; it != endIt; ++it, ++numEntities_)
+            if (numEntities_ % chunkSize_ == 0)
+                chunkBegin_.push_back(it);
+
+        // the end iterator is stored as the beginning of an additional, empty chunk
+        chunkBegin_.push_back(endIt);
+
+        sequenceNumber_ = sequenceNumber;
+    }
+
+    /*!
+     * \brief The sequence number of the grid for which the chunks were determined.
+     *
+     * If update() has not yet been called, this is -1.
+     */
+    int sequenceNumber() const
+    { return sequenceNumber_; }
+
+    /*!
+     * \brief The number of non-empty chunks.
+     */
+    size_t numChunks() const
+    { return chunkBegin_.size() - 1; }
+
+    /*!
+     * \brief The iterator pointing to the first entity of a chunk.
+     */
+    const EntityIterator& chunkBegin(size_t chunkIdx) const
+    { return chunkBegin_[chunkIdx]; }
+
+    /*!
+     * \brief The number of entities of a chunk.
+     */
+    size_t chunkSize(size_t chunkIdx) const
+    { return std::min<size_t>(chunkSize_, numEntities_ - chunkIdx*chunkSize_); }
+
+    /*!
+     * \brief The end iterator of the grid view.
+     */
+    const EntityIterator& end() const
+    { return chunkBegin_.back(); }
+
+private:
+    int sequenceNumber_;
+    size_t chunkSize_;
+    size_t numEntities_;
+    std::vector<EntityIterator> chunkBegin_;
+};
+
 /*!
  * \brief Provides an STL-iterator like interface to iterate over the enties of a
  *        GridView in OpenMP threaded applications
  *
+ * Each thread claims a chunk of consecutive entities at a time. If the iterator is
+ * constructed from a ThreadedEntityChunks object, chunks are claimed using an atomic
+ * counter, else the grid is traversed under a lock, i.e., the lock is only taken once
+ * per chunk instead of once per entity.
+ *
  * ATTENTION: This class must be instantiated in a sequential context!
  */
 template <class GridView, int codim>
@@ -43,26 +140,42 @@ class ThreadedEntityIterator
 {
     using Entity = typename GridView::template Codim<codim>::Entity;
     using EntityIterator = typename GridView::template Codim<codim>::Iterator;
+    using Chunks = ThreadedEntityChunks<GridView, codim>;
+
+    // the state of a thread: the current entity and the number of entities left in the
+    // thread's chunk. this is padded to a cache line to avoid false sharing.
+    struct alignas(64) ThreadState_
+    {
+        EntityIterator it;
+        size_t remaining;
+    };
+
 public:
-    ThreadedEntityIterator(const GridView& gridView)
+    ThreadedEntityIterator(const GridView& gridView, unsigned chunkSize = 1)
         : gridView_(gridView)
         , sequentialIt_(gridView_.template begin<codim>())
         , sequentialEnd_(gridView.template end<codim>())
+        , chunks_(nullptr)
+        , chunkSize_(std::max(chunkSize, 1u))
+        , nextChunkIdx_(0)
+        , finished_(false)
+        , threadState_(maxThreads_(), ThreadState_{sequentialEnd_, 0})
     { }
 
-    ThreadedEntityIterator(const ThreadedEntityIterator& other) = default;
+    ThreadedEntityIterator(const GridView& gridView, const Chunks& chunks)
+        : gridView_(gridView)
+        , sequentialIt_(chunks.end())
+        , sequentialEnd_(chunks.end())
+        , chunks_(&chunks)
+        , chunkSize_(1)
+        , nextChunkIdx_(0)
+        , finished_(false)
+        , threadState_(maxThreads_(), ThreadState_{sequentialEnd_, 0})
+    { }
 
     // begin iterating over the grid in parallel
     EntityIterator beginParallel()
-    {
-        mutex_.lock();
-        auto tmp = sequentialIt_;
-        if (sequentialIt_ != sequentialEnd_)
-            ++sequentialIt_; // make the next thread look at the next element
-        mutex_.unlock();
-
-        return tmp;
-    }
+    { return claimChunk_(threadState_[threadId_()]); }
 
     // returns true if the last element was reached
     bool isFinished(const EntityIterator& it) const
@@ -73,6 +186,7 @@ public:
     {
         mutex_.lock();
         sequentialIt_ = sequentialEnd_;
+        finished_ = true;
         mutex_.unlock();
     }
 
@@ -80,20 +194,76 @@ public:
     // thread
     EntityIterator increment()
     {
+        ThreadState_& state = threadState_[threadId_()];
+        if (state.remaining > 0 && !finished_.load(std::memory_order_relaxed)) {
+            ++state.it;
+            --state.remaining;
+            return state.it;
+        }
+
+        return claimChunk_(state);
+    }
+
+private:
+    EntityIterator claimChunk_(ThreadState_& state)
+    {
+        state.remaining = 0;
+        if (finished_.load(std::memory_order_relaxed))
+            return sequentialEnd_;
+
+        if (chunks_) {
+            size_t chunkIdx = nextChunkIdx_.fetch_add(1, std::memory_order_relaxed);
+            if (chunkIdx >= chunks_->numChunks())
+                return sequentialEnd_;
+
+            state.it = chunks_->chunkBegin(chunkIdx);
+            state.remaining = chunks_->chunkSize(chunkIdx) - 1;
+            return state.it;
+        }
+
         mutex_.lock();
-        auto tmp = sequentialIt_;
-        if (sequentialIt_ != sequentialEnd_)
+        state.it = sequentialIt_;
+        if (sequentialIt_ != sequentialEnd_) {
+            // make the next thread look at the element after the current chunk
             ++sequentialIt_;
+            while (state.remaining + 1 < chunkSize_ && sequentialIt_ != sequentialEnd_) {
+                ++sequentialIt_;
+                ++state.remaining;
+            }
+        }
         mutex_.unlock();
 
-        return tmp;
+        return state.it;
+    }
+
+    static unsigned threadId_()
+    {
+#ifdef _OPENMP
+        return static_cast<unsigned>(omp_get_thread_num());
+#else
+        return 0;
+#endif
+    }
+
+    static unsigned maxThreads_()
+    {
+#ifdef _OPENMP
+        return static_cast<unsigned>(omp_get_max_threads());
+#else
+        return 1;
+#endif
     }
 
-private:
     GridView gridView_;
     EntityIterator sequentialIt_;
     EntityIterator sequentialEnd_;
 
+    const Chunks* chunks_;
+    size_t chunkSize_;
+    std::atomic<size_t> nextChunkIdx_;
+    std::atomic<bool> finished_;
+    std::vector<ThreadState_> threadState_;
+
     std::mutex mutex_;
 };
 } // namespace Opm
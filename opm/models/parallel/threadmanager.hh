@@ -36,6 +36,8 @@
 
 #include <dune/common/version.hh>
 
+#include <algorithm>
+
 namespace Opm {
 
 /*!
@@ -62,11 +64,15 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, int, ThreadsPerProcess,
                              "The maximum number of threads to be instantiated per process "
                              "('-1' means 'automatic')");
+        EWOMS_REGISTER_PARAM(TypeTag, unsigned, ThreadChunkSize,
+                             "The number of consecutive elements which are handed to a "
+                             "thread at a time");
     }
 
     static void init()
     {
         numThreads_ = EWOMS_GET_PARAM(TypeTag, int, ThreadsPerProcess);
+        chunkSize_ = std::max(EWOMS_GET_PARAM(TypeTag, unsigned, ThreadChunkSize), 1u);
 
         // some safety checks. This is pretty ugly macro-magic, but so what?
 #if !defined(_OPENMP)
@@ -103,6 +109,13 @@ public:
     static unsigned maxThreads()
     { return static_cast<unsigned>(numThreads_); }
 
+    /*!
+     * \brief Return the number of consecutive elements which are handed to a thread at a
+     *        time by threaded loops over the grid.
+     */
+    static unsigned chunkSize()
+    { return chunkSize_; }
+
     /*!
      * \brief Return the index of the current OpenMP thread
      */
@@ -117,10 +130,14 @@ public:
 
 private:
     static int numThreads_;
+    static unsigned chunkSize_;
 };
 
 template <class TypeTag>
 int ThreadManager<TypeTag>::numThreads_ = 1;
+
+template <class TypeTag>
+unsigned ThreadManager<TypeTag>::chunkSize_ = 1;
 } // namespace Opm
 
 #endif
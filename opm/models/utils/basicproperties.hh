@@ -128,6 +128,15 @@ struct PrintProperties { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct PrintParameters { using type = UndefinedProperty; };
 
+/*!
+ * \brief Count how often each run-time parameter is queried?
+ *
+ * If enabled, the numbers are printed at the end of the simulation. This is intended to
+ * spot parameters which are retrieved on performance critical code paths.
+ */
+template<class TypeTag, class MyTypeTag>
+struct CountParameterQueries { using type = UndefinedProperty; };
+
 //! The default value for the simulation's end time
 template<class TypeTag, class MyTypeTag>
 struct EndTime { using type = UndefinedProperty; };
@@ -140,10 +149,30 @@ struct InitialTimeStepSize { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct RestartTime { using type = UndefinedProperty; };
 
+//! The format of the restart files ("text" or "binary")
+template<class TypeTag, class MyTypeTag>
+struct RestartFormat { using type = UndefinedProperty; };
+
+//! Store and verify checksums in binary restart files
+template<class TypeTag, class MyTypeTag>
+struct EnableRestartChecksum { using type = UndefinedProperty; };
+
+//! Write restart files in a separate thread
+template<class TypeTag, class MyTypeTag>
+struct EnableAsyncRestartOutput { using type = UndefinedProperty; };
+
 //! The name of the file with a number of forced time step lengths
 template<class TypeTag, class MyTypeTag>
 struct PredeterminedTimeStepsFile { using type = UndefinedProperty; };
 
+//! Record the time spent in the hot spots of the simulator
+template<class TypeTag, class MyTypeTag>
+struct EnableProfiling { using type = UndefinedProperty; };
+
+//! The name of the file to which the profiling events are written
+template<class TypeTag, class MyTypeTag>
+struct ProfilingTraceFile { using type = UndefinedProperty; };
+
 //! domain size
 template<class TypeTag, class MyTypeTag>
 struct DomainSizeX { using type = UndefinedProperty; };
@@ -246,6 +275,10 @@ struct PrintProperties<TypeTag, TTag::NumericModel> { static constexpr int value
 template<class TypeTag>
 struct PrintParameters<TypeTag, TTag::NumericModel> { static constexpr int value = 2; };
 
+//! By default, do not count the queries of the run-time parameters
+template<class TypeTag>
+struct CountParameterQueries<TypeTag, TTag::NumericModel> { static constexpr bool value = false; };
+
 //! The default value for the simulation's end time
 template<class TypeTag>
 struct EndTime<TypeTag, TTag::NumericModel>
@@ -270,10 +303,30 @@ struct RestartTime<TypeTag, TTag::NumericModel>
     static constexpr type value = -1e35;
 };
 
+//! By default, write restart files as text
+template<class TypeTag>
+struct RestartFormat<TypeTag, TTag::NumericModel> { static constexpr auto value = "text"; };
+
+//! By default, binary restart files are checksummed
+template<class TypeTag>
+struct EnableRestartChecksum<TypeTag, TTag::NumericModel> { static constexpr bool value = true; };
+
+//! By default, restart files are written asynchronously
+template<class TypeTag>
+struct EnableAsyncRestartOutput<TypeTag, TTag::NumericModel> { static constexpr bool value = true; };
+
 //! By default, do not force any time steps
 template<class TypeTag>
 struct PredeterminedTimeStepsFile<TypeTag, TTag::NumericModel> { static constexpr auto value = ""; };
 
+//! By default, the simulator is not profiled
+template<class TypeTag>
+struct EnableProfiling<TypeTag, TTag::NumericModel> { static constexpr bool value = false; };
+
+//! By default, no profiling trace is written
+template<class TypeTag>
+struct ProfilingTraceFile<TypeTag, TTag::NumericModel> { static constexpr auto value = ""; };
+
 
 } // namespace Opm::Properties
 
@@ -43,9 +43,14 @@
 #include <dune/common/classname.hh>
 #include <dune/common/parametertree.hh>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <set>
 #include <list>
+#include <vector>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -114,8 +119,8 @@
  * \endcode
  */
 #define EWOMS_GET_PARAM(TypeTag, ParamType, ParamName)                         \
-    (::Opm::Parameters::get<TypeTag, ParamType>(#ParamName, #ParamName, \
-                                                getPropValue<TypeTag, Properties::ParamName>()))
+    (::Opm::Parameters::getCached<TypeTag, ParamType, Properties::ParamName>(#ParamName, \
+                                                                           getPropValue<TypeTag, Properties::ParamName>()))
 
 //!\cond SKIP_THIS
 #define EWOMS_GET_PARAM_(TypeTag, ParamType, ParamName)                 \
@@ -240,9 +245,46 @@ struct ParameterMetaData<TypeTag, TTag::ParameterSystem>
 {
     using type = Dune::ParameterTree;
 
+    /*!
+     * \brief Returns the parameter tree for modification.
+     *
+     * Since the caller may change the values of the parameters, the cached parameter
+     * values are invalidated.
+     */
     static Dune::ParameterTree& tree()
+    {
+        invalidateCachedValues();
+        return *storage_().tree;
+    }
+
+    static const Dune::ParameterTree& constTree()
     { return *storage_().tree; }
 
+    /*!
+     * \brief Returns a number which changes whenever cached parameter values become
+     *        outdated.
+     */
+    static unsigned cacheGeneration()
+    { return storage_().cacheGeneration.load(std::memory_order_acquire); }
+
+    static void invalidateCachedValues()
+    { storage_().cacheGeneration.fetch_add(1, std::memory_order_acq_rel); }
+
+    static std::mutex& cacheMutex()
+    { return storage_().cacheMutex; }
+
+    //! Specifies whether the number of queries of each parameter should be counted
+    static std::atomic<bool>& countQueries()
+    { return storage_().countQueries; }
+
+    //! Returns the counter for the queries of a parameter. The cache mutex must be held.
+    static std::atomic<std::uint64_t>& queryCount(const std::string& paramName)
+    { return storage_().queryCounts.try_emplace(paramName, 0).first->second; }
+
+    //! Returns the number of queries of all parameters. The cache mutex must be held.
+    static const std::map<std::string, std::atomic<std::uint64_t> >& queryCounts()
+    { return storage_().queryCounts; }
+
     static std::map<std::string, ::Opm::Parameters::ParamInfo>& mutableRegistry()
     { return storage_().registry; }
 
@@ -257,10 +299,13 @@ struct ParameterMetaData<TypeTag, TTag::ParameterSystem>
 
     static void clear()
     {
+        std::lock_guard<std::mutex> lock(cacheMutex());
         storage_().tree.reset(new Dune::ParameterTree());
         storage_().finalizers.clear();
         storage_().registrationOpen = true;
         storage_().registry.clear();
+        storage_().queryCounts.clear();
+        invalidateCachedValues();
     }
 
 private:
@@ -270,6 +315,8 @@ private:
     // times...
     struct Storage_ {
         Storage_()
+            : cacheGeneration(1)
+            , countQueries(false)
         {
             tree.reset(new Dune::ParameterTree());
             registrationOpen = true;
@@ -279,6 +326,11 @@ private:
         std::map<std::string, ::Opm::Parameters::ParamInfo> registry;
         std::list<std::unique_ptr<::Opm::Parameters::ParamRegFinalizerBase_> > finalizers;
         bool registrationOpen;
+
+        std::atomic<unsigned> cacheGeneration;
+        std::mutex cacheMutex;
+        std::atomic<bool> countQueries;
+        std::map<std::string, std::atomic<std::uint64_t> > queryCounts;
     };
     static Storage_& storage_() {
         static Storage_ obj;
@@ -482,7 +534,7 @@ void printParamList_(std::ostream& os, const std::list<std::string>& keyList, bo
 {
     using ParamsMeta = GetProp<TypeTag, Properties::ParameterMetaData>;
 
-    const Dune::ParameterTree& tree = ParamsMeta::tree();
+    const Dune::ParameterTree& tree = ParamsMeta::constTree();
 
     auto keyIt = keyList.begin();
     const auto& keyEndIt = keyList.end();
@@ -780,6 +832,7 @@ std::string parseCommandLineOptions(int argc,
         // Put the key=value pair into the parameter tree
         paramTree[paramName] = paramValue;
     }
+    GetProp<TypeTag, Properties::ParameterMetaData>::invalidateCachedValues();
     return "";
 }
 
@@ -848,6 +901,7 @@ void parseParameterFile(const std::string& fileName, bool overwrite = true)
         if (overwrite || !paramTree.hasKey(canonicalKey))
             paramTree[canonicalKey] = value;
     }
+    GetProp<TypeTag, Properties::ParameterMetaData>::invalidateCachedValues();
 }
 
 /*!
@@ -861,7 +915,7 @@ void printValues(std::ostream& os = std::cout)
 {
     using ParamsMeta = GetProp<TypeTag, Properties::ParameterMetaData>;
 
-    const Dune::ParameterTree& tree = ParamsMeta::tree();
+    const Dune::ParameterTree& tree = ParamsMeta::constTree();
 
     std::list<std::string> runTimeAllKeyList;
     std::list<std::string> runTimeKeyList;
@@ -929,7 +983,7 @@ bool printUnused(std::ostream& os = std::cout)
 {
     using ParamsMeta = GetProp<TypeTag, Properties::ParameterMetaData>;
 
-    const Dune::ParameterTree& tree = ParamsMeta::tree();
+    const Dune::ParameterTree& tree = ParamsMeta::constTree();
     std::list<std::string> runTimeAllKeyList;
     std::list<std::string> unknownKeyList;
 
@@ -1010,7 +1064,7 @@ public:
         std::string canonicalName(paramName);
 
         // check whether the parameter is in the parameter tree
-        return ParamsMeta::tree().hasKey(canonicalName);
+        return ParamsMeta::constTree().hasKey(canonicalName);
     }
 
 
@@ -1094,7 +1148,7 @@ private:
         std::string canonicalName(paramName);
 
         // retrieve actual parameter from the parameter tree
-        return ParamsMeta::tree().template get<ParamType>(canonicalName, defaultValue);
+        return ParamsMeta::constTree().template get<ParamType>(canonicalName, defaultValue);
     }
 };
 
@@ -1112,6 +1166,78 @@ const ParamType get(const char *propTagName, const char *paramName, const ParamT
     return Param<TypeTag>::template get<ParamType>(propTagName, paramName, defaultValue, errorIfNotRegistered);
 }
 
+template <class ParamType>
+struct CachedParam_
+{
+    CachedParam_()
+        : generation(0)
+        , queryCount(nullptr)
+    {}
+
+    std::atomic<unsigned> generation;
+    ParamType value;
+    std::atomic<std::uint64_t>* queryCount;
+};
+
+/*!
+ * \brief Retrieve a registered parameter via a cache for the parameter.
+ *
+ * The value is only looked up in the parameter tree if the tree might have been
+ * modified since the previous call. Otherwise, this amounts to reading a plain value.
+ * The template template argument is the property of the parameter and only serves to
+ * give each parameter its own cache. The default value is only converted to the type
+ * of the parameter if the parameter tree is consulted.
+ */
+template <class TypeTag, class ParamType, template<class, class> class Property, class DefaultValue>
+ParamType getCached(const char *paramName, const DefaultValue& defaultValue)
+{
+    using ParamsMeta = GetProp<TypeTag, Properties::ParameterMetaData>;
+    static CachedParam_<ParamType> cache;
+
+    unsigned generation = ParamsMeta::cacheGeneration();
+    if (cache.generation.load(std::memory_order_acquire) != generation) {
+        std::lock_guard<std::mutex> lock(ParamsMeta::cacheMutex());
+        if (cache.generation.load(std::memory_order_relaxed) != generation) {
+            cache.value = Param<TypeTag>::template get<ParamType>(paramName, paramName, ParamType(defaultValue));
+            cache.queryCount = &ParamsMeta::queryCount(paramName);
+            cache.generation.store(generation, std::memory_order_release);
+        }
+    }
+
+    if (ParamsMeta::countQueries().load(std::memory_order_relaxed))
+        cache.queryCount->fetch_add(1, std::memory_order_relaxed);
+
+    return cache.value;
+}
+
+/*!
+ * \ingroup Parameter
+ * \brief Print how often each parameter was queried using EWOMS_GET_PARAM.
+ *
+ * The parameters are printed in descending order of their number of queries. Counting
+ * must be enabled beforehand using ParameterMetaData::countQueries().
+ *
+ * \param os The \c std::ostream on which the message should be printed
+ */
+template <class TypeTag>
+void printQueryCounts(std::ostream& os = std::cout)
+{
+    using ParamsMeta = GetProp<TypeTag, Properties::ParameterMetaData>;
+
+    std::vector<std::pair<std::uint64_t, std::string> > counts;
+    {
+        std::lock_guard<std::mutex> lock(ParamsMeta::cacheMutex());
+        for (const auto& nameCount : ParamsMeta::queryCounts())
+            counts.emplace_back(nameCount.second.load(), nameCount.first);
+    }
+    std::sort(counts.rbegin(), counts.rend());
+
+    os << "# [number of queries of the run-time parameters]\n";
+    for (const auto& countName : counts)
+        os << countName.second << "=" << countName.first << "\n";
+    os << std::flush;
+}
+
 template <class TypeTag, class Container>
 void getLists(Container& usedParams, Container& unusedParams)
 {
@@ -1125,7 +1251,7 @@ void getLists(Container& usedParams, Container& unusedParams)
 
     // get all parameter keys
     std::list<std::string> allKeysList;
-    const auto& paramTree = ParamsMeta::tree();
+    const auto& paramTree = ParamsMeta::constTree();
     getFlattenedKeyList_(allKeysList, paramTree);
 
     for (const auto& key : allKeysList) {
@@ -0,0 +1,410 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::Profiler
+ */
+#ifndef EWOMS_PROFILER_HH
+#define EWOMS_PROFILER_HH
+
+#include <opm/models/utils/basicproperties.hh>
+#include <opm/models/utils/parametersystem.hh>
+#include <opm/models/utils/propertysystem.hh>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup Common
+ *
+ * \brief Records the wall clock time spent in the hot spots of the simulator.
+ *
+ * The time is measured by creating Profiler::Scope objects which record the time
+ * between their construction and their destruction for a given region. Each thread
+ * uses its own storage, so scopes may be used inside of parallel regions without any
+ * synchronization. If profiling is disabled (the default), a scope only costs a
+ * branch.
+ *
+ * The regions are hierarchical, e.g., the evaluation of the fluxes is a part of the
+ * linearization of an element which itself is part of the linearization of the whole
+ * system. For the coarse regions, each scope is also stored as an event which can be
+ * written to a trace file in the JSON format of the Chrome trace viewer. (This format
+ * can also be read by Perfetto.) The fine regions, i.e., the ones which are entered
+ * once per element, are only accumulated.
+ *
+ * At the end of the simulation, the minimum, average and maximum time of each region
+ * over all processes is printed. The time of a process is the maximum of the times
+ * of its threads, and the thread imbalance is the ratio between this value and the
+ * average time of the threads which entered the region.
+ */
+template <class TypeTag>
+class Profiler
+{
+public:
+    //! The regions for which the time is recorded
+    enum Region {
+        Linearization,
+        IntensiveQuantities,
+        ElementLinearization,
+        LocalLinearization,
+        FluxEvaluation,
+        Scatter,
+        LinearSolve,
+        PreconditionerSetup,
+        KrylovIterations,
+        OverlapSync,
+        Output,
+        NumRegions
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct RegionInfo_
+    {
+        const char* name;
+        int parent;
+        bool traced;
+    };
+
+    struct Event_
+    {
+        int region;
+        double begin; // [us] since the initialization of the profiler
+        double end;
+    };
+
+    // the data recorded by a single thread. The alignment avoids false sharing.
+    struct alignas(64) ThreadData_
+    {
+        std::array<double, NumRegions> totalTime{};
+        std::array<std::uint64_t, NumRegions> numCalls{};
+        std::vector<Event_> events;
+    };
+
+public:
+    /*!
+     * \brief Records the time spent in a region between its construction and its
+     *        destruction.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(Region region)
+            : region_(region)
+            , active_(Profiler::isEnabled())
+        {
+            if (active_)
+                begin_ = Clock::now();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope()
+        {
+            if (active_)
+                Profiler::record_(region_, begin_, Clock::now());
+        }
+
+    private:
+        Region region_;
+        bool active_;
+        Clock::time_point begin_;
+    };
+
+    /*!
+     * \brief Register all run-time parameters of the profiler.
+     */
+    static void registerParameters()
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableProfiling,
+                             "Record the time spent in the hot spots of the simulator and "
+                             "print a summary at the end of the simulation");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, ProfilingTraceFile,
+                             "The file to which the recorded events are written in the "
+                             "Chrome trace format. If empty, no trace is written");
+    }
+
+    /*!
+     * \brief Initialize the profiler.
+     *
+     * This must be called after the number of threads has been determined.
+     */
+    static void init()
+    {
+        enabled_ = EWOMS_GET_PARAM(TypeTag, bool, EnableProfiling);
+        traceFile_ = EWOMS_GET_PARAM(TypeTag, std::string, ProfilingTraceFile);
+        // the events are only kept if they are written to a trace file
+        recordEvents_ = !traceFile_.empty();
+
+        unsigned numThreads = 1;
+#ifdef _OPENMP
+        numThreads = static_cast<unsigned>(omp_get_max_threads());
+#endif
+        threadData_.clear();
+        threadData_.resize(numThreads);
+        startTime_ = Clock::now();
+    }
+
+    /*!
+     * \brief Returns true iff the time spent in the regions is recorded.
+     */
+    static bool isEnabled()
+    { return enabled_; }
+
+    /*!
+     * \brief Print the minimum, average and maximum time spent in each region over all
+     *        processes and write the trace file if requested.
+     *
+     * This method is collective, i.e., it must be called on all processes.
+     *
+     * \param comm The collective communication object of the grid view
+     */
+    template <class Communication>
+    static void finalize(const Communication& comm)
+    {
+        if (!enabled_)
+            return;
+
+        printSummary_(comm);
+        if (recordEvents_)
+            writeTrace_(comm);
+    }
+
+private:
+    static const RegionInfo_& regionInfo_(int region)
+    {
+        static const RegionInfo_ info[NumRegions] = {
+            { "Linearization", /*parent=*/-1, /*traced=*/true },
+            { "Intensive quantities", Linearization, true },
+            { "Element linearization", Linearization, true },
+            { "Local linearization", ElementLinearization, false },
+            { "Flux evaluation", LocalLinearization, false },
+            { "Scatter", ElementLinearization, false },
+            { "Linear solve", /*parent=*/-1, true },
+            { "Preconditioner setup", LinearSolve, true },
+            { "Krylov iterations", LinearSolve, true },
+            { "Overlap synchronization", /*parent=*/-1, true },
+            { "Output", /*parent=*/-1, true },
+        };
+        return info[region];
+    }
+
+    static int depth_(int region)
+    {
+        int depth = 0;
+        for (int r = regionInfo_(region).parent; r >= 0; r = regionInfo_(r).parent)
+            ++ depth;
+        return depth;
+    }
+
+    static unsigned threadId_()
+    {
+#ifdef _OPENMP
+        return static_cast<unsigned>(omp_get_thread_num());
+#else
+        return 0;
+#endif
+    }
+
+    static void record_(Region region, Clock::time_point begin, Clock::time_point end)
+    {
+        unsigned threadId = threadId_();
+        if (threadId >= threadData_.size())
+            return; // thread was not accounted for, e.g., nested parallelism
+
+        ThreadData_& data = threadData_[threadId];
+        std::chrono::duration<double> dt = end - begin;
+        data.totalTime[region] += dt.count();
+        ++ data.numCalls[region];
+
+        if (recordEvents_ && regionInfo_(region).traced) {
+            std::chrono::duration<double, std::micro> t1 = begin - startTime_;
+            std::chrono::duration<double, std::micro> t2 = end - startTime_;
+            data.events.push_back(Event_{region, t1.count(), t2.count()});
+        }
+    }
+
+    template <class Communication>
+    static void printSummary_(const Communication& comm)
+    {
+        // the time of this process for each region, and the sum over its threads
+        std::array<double, NumRegions> maxThreadTime{};
+        std::array<double, NumRegions> imbalance{};
+        std::array<double, NumRegions> numCalls{};
+        for (int region = 0; region < NumRegions; ++region) {
+            double sumThreadTime = 0.0;
+            unsigned numActiveThreads = 0;
+            for (const auto& data : threadData_) {
+                if (data.numCalls[region] == 0)
+                    continue;
+
+                ++ numActiveThreads;
+                sumThreadTime += data.totalTime[region];
+                numCalls[region] += static_cast<double>(data.numCalls[region]);
+                maxThreadTime[region] = std::max(maxThreadTime[region], data.totalTime[region]);
+            }
+
+            if (numActiveThreads > 0 && sumThreadTime > 0.0)
+                imbalance[region] = maxThreadTime[region]/(sumThreadTime/numActiveThreads);
+        }
+
+        std::array<double, NumRegions> minTime = maxThreadTime;
+        std::array<double, NumRegions> avgTime = maxThreadTime;
+        std::array<double, NumRegions> maxTime = maxThreadTime;
+        comm.min(minTime.data(), NumRegions);
+        comm.sum(avgTime.data(), NumRegions);
+        comm.max(maxTime.data(), NumRegions);
+        comm.max(imbalance.data(), NumRegions);
+        comm.sum(numCalls.data(), NumRegions);
+
+        if (comm.rank() != 0)
+            return;
+
+        std::cout << "------------------------ Profiling summary ------------------------\n"
+                  << std::left << std::setw(30) << "Region"
+                  << std::right << std::setw(12) << "Calls"
+                  << std::setw(12) << "Min [s]"
+                  << std::setw(12) << "Avg [s]"
+                  << std::setw(12) << "Max [s]"
+                  << std::setw(12) << "Imbalance" << "\n";
+        for (int region = 0; region < NumRegions; ++region) {
+            if (numCalls[region] == 0)
+                continue;
+
+            std::string name = std::string(2*static_cast<size_t>(depth_(region)), ' ')
+                + regionInfo_(region).name;
+            std::cout << std::left << std::setw(30) << name
+                      << std::right << std::setw(12) << static_cast<std::uint64_t>(numCalls[region])
+                      << std::fixed << std::setprecision(3)
+                      << std::setw(12) << minTime[region]
+                      << std::setw(12) << avgTime[region]/comm.size()
+                      << std::setw(12) << maxTime[region]
+                      << std::setprecision(2)
+                      << std::setw(12) << imbalance[region] << "\n"
+                      << std::defaultfloat;
+        }
+        std::cout << "\n"
+                  << "Note: Min/Avg/Max are taken over the processes. The time of a process is\n"
+                  << "the maximum over its threads, the imbalance is the maximum ratio between\n"
+                  << "this and the average time of the threads of a process.\n"
+                  << "-------------------------------------------------------------------\n"
+                  << std::flush;
+    }
+
+    // gather the events of all processes and write them to a single file
+    template <class Communication>
+    static void writeTrace_(const Communication& comm)
+    {
+        // each event is sent as (region, thread, begin, end)
+        std::vector<double> sendBuf;
+        for (unsigned threadId = 0; threadId < threadData_.size(); ++threadId) {
+            for (const auto& event : threadData_[threadId].events) {
+                sendBuf.push_back(event.region);
+                sendBuf.push_back(threadId);
+                sendBuf.push_back(event.begin);
+                sendBuf.push_back(event.end);
+            }
+        }
+
+        int numRanks = comm.size();
+        int sendSize = static_cast<int>(sendBuf.size());
+        std::vector<int> recvSizes(static_cast<size_t>(numRanks));
+        comm.gather(&sendSize, recvSizes.data(), /*len=*/1, /*root=*/0);
+
+        std::vector<int> offsets(static_cast<size_t>(numRanks) + 1, 0);
+        for (int rank = 0; rank < numRanks; ++rank)
+            offsets[rank + 1] = offsets[rank] + recvSizes[rank];
+
+        std::vector<double> recvBuf(static_cast<size_t>(std::max(offsets[numRanks], 1)));
+        comm.gatherv(sendBuf.data(), sendSize, recvBuf.data(),
+                     recvSizes.data(), offsets.data(), /*root=*/0);
+
+        if (comm.rank() != 0)
+            return;
+
+        std::ofstream os(traceFile_);
+        os << std::setprecision(12) << "{\"traceEvents\":[\n";
+        bool first = true;
+        for (int rank = 0; rank < numRanks; ++rank) {
+            os << (first?"":",\n")
+               << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+               << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+            first = false;
+
+            for (int i = offsets[rank]; i < offsets[rank + 1]; i += 4) {
+                int region = static_cast<int>(recvBuf[i]);
+                int threadId = static_cast<int>(recvBuf[i + 1]);
+                os << ",\n{\"name\":\"" << regionInfo_(region).name << "\""
+                   << ",\"cat\":\"opm\",\"ph\":\"X\""
+                   << ",\"pid\":" << rank
+                   << ",\"tid\":" << threadId
+                   << ",\"ts\":" << recvBuf[i + 2]
+                   << ",\"dur\":" << recvBuf[i + 3] - recvBuf[i + 2] << "}";
+            }
+        }
+        os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        std::cout << "Wrote the profiling trace to '" << traceFile_ << "'\n" << std::flush;
+    }
+
+    static bool enabled_;
+    static std::string traceFile_;
+    static bool recordEvents_;
+    static Clock::time_point startTime_;
+    static std::vector<ThreadData_> threadData_;
+};
+
+template <class TypeTag>
+bool Profiler<TypeTag>::enabled_ = false;
+
+template <class TypeTag>
+std::string Profiler<TypeTag>::traceFile_;
+
+template <class TypeTag>
+bool Profiler<TypeTag>::recordEvents_ = false;
+
+template <class TypeTag>
+typename Profiler<TypeTag>::Clock::time_point Profiler<TypeTag>::startTime_;
+
+template <class TypeTag>
+std::vector<typename Profiler<TypeTag>::ThreadData_> Profiler<TypeTag>::threadData_;
+
+} // namespace Opm
+
+#endif
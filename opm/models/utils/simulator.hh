@@ -29,17 +29,21 @@
 #define EWOMS_SIMULATOR_HH
 
 #include <opm/models/io/restart.hh>
+#include <opm/models/io/binaryrestart.hh>
 #include <opm/models/utils/parametersystem.hh>
 
 #include <opm/models/utils/propertysystem.hh>
+#include <opm/models/utils/profiler.hh>
 #include <opm/models/utils/timer.hh>
 #include <opm/models/utils/timerguard.hh>
 #include <opm/models/parallel/mpiutil.hh>
+#include <opm/models/parallel/tasklets.hh>
 #include <opm/models/discretization/common/fvbaseproperties.hh>
 
 #include <dune/common/version.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -108,6 +112,8 @@ public:
         const auto& comm = Dune::MPIHelper::getCollectiveCommunication();
         verbose_ = verbose && comm.rank() == 0;
 
+        Opm::Profiler<TypeTag>::init();
+
         timeStepIdx_ = 0;
         startTime_ = 0.0;
         time_ = 0.0;
@@ -131,6 +137,9 @@ public:
 
         finished_ = false;
 
+        bool asyncRestartOutput = EWOMS_GET_PARAM(TypeTag, bool, EnableAsyncRestartOutput);
+        restartWriter_.reset(new TaskletRunner(/*numWorkers=*/asyncRestartOutput?1:0));
+
         if (verbose_)
             std::cout << "Allocating the simulation vanguard\n" << std::flush;
 
@@ -242,15 +251,29 @@ public:
                              "The size of the initial time step [s]");
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, RestartTime,
                              "The simulation time at which a restart should be attempted [s]");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, RestartFormat,
+                             "The format of the restart files ('text' or 'binary')");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableRestartChecksum,
+                             "Store and verify checksums for the sections of binary "
+                             "restart files");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncRestartOutput,
+                             "Write restart files in a separate thread");
         EWOMS_REGISTER_PARAM(TypeTag, std::string, PredeterminedTimeStepsFile,
                              "A file with a list of predetermined time step sizes (one "
                              "time step per line)");
 
+        Opm::Profiler<TypeTag>::registerParameters();
         Vanguard::registerParameters();
         Model::registerParameters();
         Problem::registerParameters();
     }
 
+    /*!
+     * \brief Returns true iff informational messages should be printed by this process
+     */
+    bool verbose() const
+    { return verbose_; }
+
     /*!
      * \brief Return a reference to the grid manager of simulation
      */
@@ -636,14 +659,14 @@ public:
             // try to restart a previous simulation
             time_ = restartTime;
 
-            Opm::Restart res;
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeBegin(*this, time_));
-            if (verbose_)
-                std::cout << "Deserialize from file '" << res.fileName() << "'\n" << std::flush;
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(this->deserialize(res));
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(problem_->deserialize(res));
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(model_->deserialize(res));
-            EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeEnd());
+            if (binaryRestartFormat_()) {
+                Opm::BinaryRestart res(EWOMS_GET_PARAM(TypeTag, bool, EnableRestartChecksum));
+                deserializeAll_(res);
+            }
+            else {
+                Opm::Restart res;
+                deserializeAll_(res);
+            }
             if (verbose_)
                 std::cout << "Deserialization done."
                           << " Simulator time: " << time() << humanReadableTime(time())
@@ -792,6 +815,11 @@ public:
         }
         executionTimer_.stop();
 
+        // make sure that the last restart file is complete
+        writeTimer_.start();
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(finishRestartOutput_());
+        writeTimer_.stop();
+
         EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(problem_->finalize());
     }
 
@@ -884,21 +912,24 @@ public:
      * method, has the current time of the simulation clock in it's
      * name and uses the extension <tt>.ers</tt>. (Ewoms ReStart
      * file.)  See Opm::Restart for details.
+     *
+     * If asynchronous restart output is enabled, the state is only serialized into
+     * memory and the restart file is written by a separate thread. In this case, the
+     * previous restart file is completed first, i.e., at most one restart file is kept
+     * in memory.
      */
     void serialize()
     {
-        using Restarter = Opm::Restart;
-        Restarter res;
-        res.serializeBegin(*this);
-        if (gridView().comm().rank() == 0)
-            std::cout << "Serialize to file '" << res.fileName() << "'"
-                      << ", next time step size: " << timeStepSize()
-                      << "\n" << std::flush;
+        finishRestartOutput_();
 
-        this->serialize(res);
-        problem_->serialize(res);
-        model_->serialize(res);
-        res.serializeEnd();
+        if (binaryRestartFormat_()) {
+            Opm::BinaryRestart res(EWOMS_GET_PARAM(TypeTag, bool, EnableRestartChecksum));
+            serializeAll_(res);
+        }
+        else {
+            Opm::Restart res;
+            serializeAll_(res);
+        }
     }
 
     /*!
@@ -944,10 +975,106 @@ public:
     }
 
 private:
+    // writes the staged contents of a restart file to disk
+    class WriteRestartFileTasklet : public TaskletInterface
+    {
+    public:
+        WriteRestartFileTasklet(const std::string& fileName,
+                                std::string data,
+                                std::string& errorMessage)
+            : fileName_(fileName)
+            , data_(std::move(data))
+            , errorMessage_(errorMessage)
+        { }
+
+        void run() final
+        {
+            // write into a temporary file first, so that no truncated restart file is
+            // left behind if writing fails
+            std::string tmpFileName = fileName_ + ".tmp";
+            std::ofstream os(tmpFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+            os.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+            os.close();
+
+            if (!os.good() || std::rename(tmpFileName.c_str(), fileName_.c_str()) != 0)
+                errorMessage_ = "Could not write restart file '"+fileName_+"'";
+        }
+
+    private:
+        std::string fileName_;
+        std::string data_;
+        std::string& errorMessage_;
+    };
+
+    // wait until the restart file which is currently written asynchronously is
+    // complete and report errors which occurred while writing it
+    void finishRestartOutput_()
+    {
+        restartWriter_->barrier();
+
+        if (!restartWriteError_.empty()) {
+            std::string msg = restartWriteError_;
+            restartWriteError_.clear();
+            throw std::runtime_error(msg);
+        }
+    }
+
+    static bool binaryRestartFormat_()
+    {
+        const std::string format = EWOMS_GET_PARAM(TypeTag, std::string, RestartFormat);
+        if (format == "binary")
+            return true;
+        else if (format == "text")
+            return false;
+
+        throw std::runtime_error("Unknown restart file format '"+format+"'");
+    }
+
+    template <class Restarter>
+    void serializeAll_(Restarter& res)
+    {
+        bool async = restartWriter_->numWorkerThreads() > 0;
+        if (async)
+            res.enableStaging();
+
+        res.serializeBegin(*this);
+        if (gridView().comm().rank() == 0)
+            std::cout << "Serialize to file '" << res.fileName() << "'"
+                      << ", next time step size: " << timeStepSize()
+                      << "\n" << std::flush;
+
+        this->serialize(res);
+        problem_->serialize(res);
+        model_->serialize(res);
+        res.serializeEnd();
+
+        if (async)
+            restartWriter_->dispatch(std::make_shared<WriteRestartFileTasklet>(res.fileName(),
+                                                                                res.stagedData(),
+                                                                                restartWriteError_));
+    }
+
+    template <class Restarter>
+    void deserializeAll_(Restarter& res)
+    {
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeBegin(*this, time_));
+        if (verbose_)
+            std::cout << "Deserialize from file '" << res.fileName() << "'\n" << std::flush;
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(this->deserialize(res));
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(problem_->deserialize(res));
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(model_->deserialize(res));
+        EWOMS_CATCH_PARALLEL_EXCEPTIONS_FATAL(res.deserializeEnd());
+    }
+
     std::unique_ptr<Vanguard> vanguard_;
     std::unique_ptr<Model> model_;
     std::unique_ptr<Problem> problem_;
 
+    // the error message must outlive the tasklet runner because pending tasklets are
+    // run by its destructor
+    std::string restartWriteError_;
+    std::unique_ptr<TaskletRunner> restartWriter_;
+
     int episodeIdx_;
     Scalar episodeStartTime_;
     Scalar episodeLength_;
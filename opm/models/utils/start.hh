@@ -87,6 +87,9 @@ static inline void registerAllParameters_(bool finalizeRegistration = true)
     EWOMS_REGISTER_PARAM(TypeTag, int, PrintParameters,
                          "Print the values of the run-time parameters at the "
                          "start of the simulation");
+    EWOMS_REGISTER_PARAM(TypeTag, bool, CountParameterQueries,
+                         "Count how often each run-time parameter is queried and print "
+                         "the numbers at the end of the simulation");
 
     Simulator::registerParameters();
     ThreadManager::registerParameters();
@@ -386,12 +389,19 @@ static inline int start(int argc, char **argv,  bool registerParams=true)
                 Opm::Properties::printValues<TypeTag>();
         }
 
+        bool countParamQueries = EWOMS_GET_PARAM(TypeTag, bool, CountParameterQueries);
+        if (countParamQueries)
+            GetProp<TypeTag, Properties::ParameterMetaData>::countQueries() = true;
+
         // instantiate and run the concrete problem. make sure to
         // deallocate the problem and before the time manager and the
         // grid
         Simulator simulator;
         simulator.run();
 
+        if (countParamQueries && myRank == 0)
+            Opm::Parameters::printQueryCounts<TypeTag>();
+
         if (myRank == 0) {
             std::cout << "eWoms reached the destination. If it is not the one that was intended, "
                       << "change the booking and try again.\n"
@@ -36,10 +36,31 @@
 
 #include <opm/material/common/Exceptions.hpp>
 
+#include <dune/istl/scalarproducts.hh>
+
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace Opm {
 namespace Linear {
+namespace detail {
+//! Detects whether a scalar product can compute multiple products in a single reduction
+template <class ScalarProduct, class Vector, class = void>
+struct HasFusedDots : public std::false_type {};
+
+template <class ScalarProduct, class Vector>
+struct HasFusedDots<ScalarProduct,
+                    Vector,
+                    decltype(std::declval<const ScalarProduct&>().dots(
+                                 std::declval<const std::array<const Vector*, 1>&>(),
+                                 std::declval<const std::array<const Vector*, 1>&>()),
+                             void())>
+    : public std::true_type {};
+} // namespace detail
+
 /*!
  * \brief Implements a preconditioned stabilized BiCG linear solver.
  *
@@ -48,8 +69,17 @@ namespace Linear {
  *
  * See https://en.wikipedia.org/wiki/Biconjugate_gradient_stabilized_method, (article
  * date: December 19, 2016)
+ *
+ * If the reductions are fused and the scalar product provides a dots() method, the
+ * scalar products (t,t), (t,s), (r0hat,s) and (r0hat,t) are computed using a single pass
+ * over the vectors and a single global reduction. (r0hat,r) for the next iteration is
+ * then obtained via (r0hat,s) - omega*(r0hat,t), i.e., the number of global reductions
+ * per iteration is reduced from three to two.
  */
-template <class LinearOperator, class Vector, class Preconditioner>
+template <class LinearOperator,
+          class Vector,
+          class Preconditioner,
+          class ScalarProduct = Dune::ScalarProduct<Vector> >
 class BiCGStabSolver
 {
     using ConvergenceCriterion = Opm::Linear::ConvergenceCriterion<Vector>;
@@ -58,7 +88,7 @@ class BiCGStabSolver
 public:
     BiCGStabSolver(Preconditioner& preconditioner,
                    ConvergenceCriterion& convergenceCriterion,
-                   Dune::ScalarProduct<Vector>& scalarProduct)
+                   ScalarProduct& scalarProduct)
         : preconditioner_(preconditioner)
         , convergenceCriterion_(convergenceCriterion)
         , scalarProduct_(scalarProduct)
@@ -67,8 +97,25 @@ public:
         b_ = nullptr;
 
         maxIterations_ = 1000;
+        fuseReductions_ = false;
     }
 
+    /*!
+     * \brief Specify whether the scalar products at the end of an iteration should be
+     *        computed using a single global reduction.
+     *
+     * This only has an effect if the scalar product provides a dots() method.
+     */
+    void setFuseReductions(bool value)
+    { fuseReductions_ = value; }
+
+    /*!
+     * \brief Returns true if the scalar products at the end of an iteration are computed
+     *        using a single global reduction.
+     */
+    bool fuseReductions() const
+    { return fuseReductions_; }
+
     /*!
      * \brief Set the maximum number of iterations before we give up without achieving
      *        convergence.
@@ -192,9 +239,13 @@ public:
         Vector& t(y);
         unsigned n = x.size();
 
+        // (r0hat,r_(i-1)) if it was computed at the end of the previous iteration
+        Scalar rhoNext = 0.0;
+        bool haveRhoNext = false;
+
         for (; report_.iterations() < maxIterations_; report_.increment()) {
             // rho_i = (r0hat,r_(i-1))
-            Scalar rho_i = scalarProduct_.dot(r0hat, r);
+            Scalar rho_i = haveRhoNext ? rhoNext : scalarProduct_.dot(r0hat, r);
 
             // beta = (rho_i/rho_(i-1))*(alpha/omega_(i-1))
             if (std::abs(rho) <= breakdownEps || std::abs(omega) <= breakdownEps)
@@ -284,13 +335,36 @@ public:
             A_->apply(z, t);
 
             // omega_i = (t*s)/(t*t)
-            denom = scalarProduct_.dot(t, t);
+            Scalar ts = 0.0;
+            Scalar r0hatT = 0.0;
+            if constexpr (detail::HasFusedDots<ScalarProduct, Vector>::value) {
+                if (fuseReductions_) {
+                    // compute (r0hat,s) and (r0hat,t) alongside, because this allows to
+                    // get rho for the next iteration without an additional reduction
+                    const auto& products =
+                        scalarProduct_.dots(std::array<const Vector*, 4>{ &t, &t, &r0hat, &r0hat },
+                                            std::array<const Vector*, 4>{ &t, &s, &s, &t });
+                    denom = products[0];
+                    ts = products[1];
+                    rhoNext = products[2];
+                    r0hatT = products[3];
+                    haveRhoNext = true;
+                }
+            }
+            if (!haveRhoNext) {
+                denom = scalarProduct_.dot(t, t);
+                ts = scalarProduct_.dot(t, s);
+            }
             if (std::abs(denom) <= breakdownEps)
                 throw Opm::NumericalIssue("Breakdown of the BiCGStab solver (division by zero)");
-            omega = scalarProduct_.dot(t, s)/denom;
+            omega = ts/denom;
             if (std::abs(omega) <= breakdownEps)
                 throw Opm::NumericalIssue("Breakdown of the BiCGStab solver (stagnation detected)");
 
+            // (r0hat,r_i) = (r0hat,s) - omega_i*(r0hat,t)
+            if (haveRhoNext)
+                rhoNext -= omega*r0hatT;
+
             // x_i = h + omega_i*z
             // x = h; // not necessary because x and h are the same object
             x.axpy(/*a=*/omega, /*y=*/z);
@@ -343,11 +417,12 @@ private:
 
     Preconditioner& preconditioner_;
     ConvergenceCriterion& convergenceCriterion_;
-    Dune::ScalarProduct<Vector>& scalarProduct_;
+    ScalarProduct& scalarProduct_;
     Opm::Linear::SolverReport report_;
 
     unsigned maxIterations_;
     unsigned verbosity_;
+    bool fuseReductions_;
 };
 
 } // namespace Linear
@@ -33,10 +33,11 @@
 #include <dune/istl/operators.hh>
 
 #include <algorithm>
-#include <set>
-#include <map>
+#include <cassert>
 #include <iostream>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #if HAVE_MPI
 #include <mpi.h>
@@ -50,14 +51,17 @@ namespace Linear {
  * \brief This class maps domestic row indices to and from "global"
  *        indices which is used to construct an algebraic overlap
  *        for the parallel linear solvers.
+ *
+ * Since the domestic indices are consecutive, the global index of each domestic index
+ * is stored in a flat array while the reverse direction uses a hash map.
  */
 template <class ForeignOverlap>
 class GlobalIndices
 {
     GlobalIndices(const GlobalIndices& ) = delete;
 
-    using GlobalToDomesticMap = std::map<Index, Index>;
-    using DomesticToGlobalMap = std::map<Index, Index>;
+    using GlobalToDomesticMap = std::unordered_map<Index, Index>;
+    using DomesticToGlobalMap = std::vector<Index>;
 
 public:
     GlobalIndices(const ForeignOverlap& foreignOverlap)
@@ -87,9 +91,10 @@ public:
      */
     Index domesticToGlobal(Index domesticIdx) const
     {
-        assert(domesticToGlobal_.find(domesticIdx) != domesticToGlobal_.end());
+        assert(0 <= domesticIdx && static_cast<size_t>(domesticIdx) < domesticToGlobal_.size());
+        assert(domesticToGlobal_[static_cast<size_t>(domesticIdx)] >= 0);
 
-        return domesticToGlobal_.find(domesticIdx)->second;
+        return domesticToGlobal_[static_cast<size_t>(domesticIdx)];
     }
 
     /*!
@@ -126,11 +131,15 @@ public:
      */
     void addIndex(Index domesticIdx, Index globalIdx)
     {
-        domesticToGlobal_[domesticIdx] = globalIdx;
-        globalToDomestic_[globalIdx] = domesticIdx;
-        numDomestic_ = domesticToGlobal_.size();
+        assert(domesticIdx >= 0);
+        size_t domIdx = static_cast<size_t>(domesticIdx);
+        // unused slots of the array are marked by -1
+        if (domIdx >= domesticToGlobal_.size())
+            domesticToGlobal_.resize(domIdx + 1, /*value=*/-1);
 
-        assert(domesticToGlobal_.size() == globalToDomestic_.size());
+        domesticToGlobal_[domIdx] = globalIdx;
+        globalToDomestic_[globalIdx] = domesticIdx;
+        numDomestic_ = globalToDomestic_.size();
     }
 
     /*!
@@ -210,118 +219,113 @@ protected:
 #endif
 
 #if HAVE_MPI
-        if (myRank_ == 0) {
-            // the first rank starts at index zero
-            domesticOffset_ = 0;
-        }
-        else {
-            // all other ranks retrieve their offset from the next
-            // lower rank
-            MPI_Recv(&domesticOffset_, // buffer
-                     1,                // count
-                     MPI_INT,          // data type
-                     static_cast<int>(myRank_ - 1), // peer rank
-                     0,                // tag
-                     MPI_COMM_WORLD,   // communicator
-                     MPI_STATUS_IGNORE);
-        }
+        size_t numLocal = foreignOverlap_.numLocal();
+        int numMaster = 0;
+        for (unsigned i = 0; i < numLocal; ++i)
+            if (foreignOverlap_.iAmMasterOf(static_cast<Index>(i)))
+                ++numMaster;
+
+        // the offset of the current rank is the total number of master indices of all
+        // lower ranks. (the result of MPI_Exscan is undefined on the first rank.)
+        int offset = 0;
+        MPI_Exscan(&numMaster, &offset, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        domesticOffset_ = (myRank_ == 0) ? 0 : offset;
 
         // create maps for all indices for which the current process
         // is the master
-        int numMaster = 0;
-        for (unsigned i = 0; i < foreignOverlap_.numLocal(); ++i) {
+        domesticToGlobal_.reserve(numLocal);
+        globalToDomestic_.reserve(numLocal);
+        int masterIdx = 0;
+        for (unsigned i = 0; i < numLocal; ++i) {
             if (!foreignOverlap_.iAmMasterOf(static_cast<Index>(i)))
                 continue;
 
             addIndex(static_cast<Index>(i),
-                     static_cast<Index>(domesticOffset_ + numMaster));
-            ++numMaster;
-        }
-
-        if (myRank_ < mpiSize_ - 1) {
-            // send the domestic offset plus the number of master
-            // indices to the process which is one rank higher
-            int tmp = domesticOffset_ + numMaster;
-            MPI_Send(&tmp,            // buff
-                     1,               // count
-                     MPI_INT,         // data type
-                     static_cast<int>(myRank_ + 1), // peer rank
-                     0,               // tag
-                     MPI_COMM_WORLD); // communicator
+                     static_cast<Index>(domesticOffset_ + masterIdx));
+            ++masterIdx;
         }
 
-        typename PeerSet::const_iterator peerIt;
-        typename PeerSet::const_iterator peerEndIt = peerSet_().end();
-        // receive the border indices from the lower ranks
-        peerIt = peerSet_().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            if (*peerIt < myRank_)
-                receiveBorderFrom_(*peerIt);
-        }
-
-        // send the border indices to the higher ranks
-        peerIt = peerSet_().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            if (*peerIt > myRank_)
-                sendBorderTo_(*peerIt);
-        }
-
-        // receive the border indices from the higher ranks
-        peerIt = peerSet_().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            if (*peerIt > myRank_)
-                receiveBorderFrom_(*peerIt);
-        }
-
-        // send the border indices to the lower ranks
-        peerIt = peerSet_().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            if (*peerIt < myRank_)
-                sendBorderTo_(*peerIt);
-        }
+        // retrieve the global indices of the border indices for which we are not the
+        // master from the respective master processes
+        exchangeBorderIndices_();
 #endif // HAVE_MPI
     }
 
-    void sendBorderTo_(ProcessRank peerRank OPM_UNUSED_NOMPI)
+    // send the global indices of the border indices for which we are master to the
+    // peers and receive the ones for which the peers are master. Since the global
+    // indices of all master indices are known at this point, this only requires a
+    // single message for each pair of peers which is exchanged non-blockingly.
+    void exchangeBorderIndices_()
     {
 #if HAVE_MPI
-        // send (local index on myRank, global index) pairs to the
-        // peers
+        std::vector<ProcessRank> peerRanks(peerSet_().begin(), peerSet_().end());
+        size_t numPeers = peerRanks.size();
+
+        // sort the border indices by peer in a single pass over the border list
+        std::vector<std::vector<PeerIndexGlobalIndex> > sendBuffs(numPeers);
+        std::vector<size_t> numRecv(numPeers, 0);
         BorderList::const_iterator borderIt = borderList_().begin();
         BorderList::const_iterator borderEndIt = borderList_().end();
         for (; borderIt != borderEndIt; ++borderIt) {
             ProcessRank borderPeer = borderIt->peerRank;
             BorderDistance borderDistance = borderIt->borderDistance;
-            if (borderPeer != peerRank || borderDistance != 0)
+            if (borderDistance != 0)
                 continue;
 
+            auto peerRankIt = std::lower_bound(peerRanks.begin(), peerRanks.end(), borderPeer);
+            if (peerRankIt == peerRanks.end() || *peerRankIt != borderPeer)
+                continue;
+            size_t peerPos = static_cast<size_t>(peerRankIt - peerRanks.begin());
+
             Index localIdx = foreignOverlap_.nativeToLocal(borderIt->localIdx);
-            Index peerIdx = borderIt->peerIdx;
-            assert(localIdx >= 0);
+            if (localIdx < 0)
+                continue;
+
             if (foreignOverlap_.iAmMasterOf(localIdx)) {
-                sendBorderIndex(borderPeer, localIdx, peerIdx);
+                PeerIndexGlobalIndex tmp;
+                tmp.peerIdx = borderIt->peerIdx;
+                tmp.globalIdx = domesticToGlobal(localIdx);
+                sendBuffs[peerPos].push_back(tmp);
             }
+            else if (foreignOverlap_.masterRank(localIdx) == borderPeer)
+                ++numRecv[peerPos];
         }
-#endif // HAVE_MPI
-    }
 
-    void receiveBorderFrom_(ProcessRank peerRank OPM_UNUSED_NOMPI)
-    {
-#if HAVE_MPI
-        // retrieve the global indices for which we are not master
-        // from the processes with lower rank
-        BorderList::const_iterator borderIt = borderList_().begin();
-        BorderList::const_iterator borderEndIt = borderList_().end();
-        for (; borderIt != borderEndIt; ++borderIt) {
-            ProcessRank borderPeer = borderIt->peerRank;
-            BorderDistance borderDistance = borderIt->borderDistance;
-            if (borderPeer != peerRank || borderDistance != 0)
-                continue;
-
-            Index nativeIdx = borderIt->localIdx;
-            Index localIdx = foreignOverlap_.nativeToLocal(nativeIdx);
-            if (localIdx >= 0 && foreignOverlap_.masterRank(localIdx) == borderPeer)
-                receiveBorderIndex(borderPeer);
+        // post the receive operations and send our border indices to all peers
+        std::vector<std::vector<PeerIndexGlobalIndex> > recvBuffs(numPeers);
+        std::vector<MPI_Request> requests(2*numPeers);
+        for (size_t peerPos = 0; peerPos < numPeers; ++peerPos) {
+            recvBuffs[peerPos].resize(numRecv[peerPos]);
+            MPI_Irecv(recvBuffs[peerPos].data(),
+                      static_cast<int>(recvBuffs[peerPos].size()*sizeof(PeerIndexGlobalIndex)),
+                      MPI_BYTE,
+                      static_cast<int>(peerRanks[peerPos]),
+                      0, // tag
+                      MPI_COMM_WORLD,
+                      &requests[peerPos]);
+        }
+        for (size_t peerPos = 0; peerPos < numPeers; ++peerPos)
+            MPI_Isend(sendBuffs[peerPos].data(),
+                      static_cast<int>(sendBuffs[peerPos].size()*sizeof(PeerIndexGlobalIndex)),
+                      MPI_BYTE,
+                      static_cast<int>(peerRanks[peerPos]),
+                      0, // tag
+                      MPI_COMM_WORLD,
+                      &requests[numPeers + peerPos]);
+        std::vector<MPI_Status> statuses(requests.size());
+        MPI_Waitall(static_cast<int>(requests.size()), requests.data(), statuses.data());
+
+        // add the received indices to the translation maps
+        for (size_t peerPos = 0; peerPos < numPeers; ++peerPos) {
+            int numBytes;
+            MPI_Get_count(&statuses[peerPos], MPI_BYTE, &numBytes);
+            size_t numReceived = static_cast<size_t>(numBytes)/sizeof(PeerIndexGlobalIndex);
+            for (size_t i = 0; i < numReceived; ++i) {
+                const auto& recvBuf = recvBuffs[peerPos][i];
+                Index domesticIdx = foreignOverlap_.nativeToLocal(recvBuf.peerIdx);
+                if (domesticIdx >= 0)
+                    addIndex(domesticIdx, recvBuf.globalIdx);
+            }
         }
 #endif // HAVE_MPI
     }
@@ -72,9 +72,12 @@ public:
 
     /*!
      * \brief Allocate matrix structure give a sparsity pattern.
+     *
+     * The pattern can either be a std::vector of sets of column indices or a
+     * Linear::SparsityPattern object.
      */
-    template <class Set>
-    void reserve(const std::vector<Set>& sparsityPattern)
+    template <class SparsityPattern>
+    void reserve(const SparsityPattern& sparsityPattern)
     {
         // allocate raw matrix
         istlMatrix_.reset(new IstlMatrix(rows_, columns_, IstlMatrix::random));
@@ -167,6 +170,22 @@ public:
     void addToBlock(const size_t rowIdx, const size_t colIdx, const MatrixBlock& value)
     { (*istlMatrix_)[rowIdx][colIdx] += value; }
 
+    /*!
+     * \brief Return the address of a matrix block.
+     *
+     * This allows to write to a block without looking it up in the sparsity pattern
+     * every time. The address stays valid until the structure of the matrix is
+     * re-created, i.e., until reserve() is called the next time.
+     */
+    MatrixBlock* blockAddress(const size_t rowIdx, const size_t colIdx)
+    { return &(*istlMatrix_)[rowIdx][colIdx]; }
+
+    /*!
+     * \copydoc blockAddress()
+     */
+    const MatrixBlock* blockAddress(const size_t rowIdx, const size_t colIdx) const
+    { return &(*istlMatrix_)[rowIdx][colIdx]; }
+
     /*!
      * \brief Commit matrix from local caches into matrix native structure.
      *
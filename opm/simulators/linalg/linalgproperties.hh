@@ -104,8 +104,26 @@ struct GlobalEqVector { using type = UndefinedProperty; };
 
 template<class TypeTag, class MyTypeTag>
 struct AmgCoarsenTarget { using type = UndefinedProperty; };
+//! Keep the aggregates of the AMG across linear solves and only recompute the coarse
+//! level operators
+template<class TypeTag, class MyTypeTag>
+struct AmgReuseHierarchy { using type = UndefinedProperty; };
+//! The maximum number of linear solves between two full setups of the AMG
+template<class TypeTag, class MyTypeTag>
+struct AmgMaxHierarchyReuses { using type = UndefinedProperty; };
+//! Redo the full AMG setup if the number of linear iterations grows by this factor
+template<class TypeTag, class MyTypeTag>
+struct AmgReuseIterationGrowth { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct LinearSolverMaxError { using type = UndefinedProperty; };
+//! Keep the factorization of a direct solver across matrix updates and use it as the
+//! preconditioner of an iterative refinement
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverReuseFactorization { using type = UndefinedProperty; };
+//! Compute the scalar products at the end of a BiCGStab iteration using a single
+//! global reduction
+template<class TypeTag, class MyTypeTag>
+struct LinearSolverFuseReductions { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
 struct LinearSolverWrapper { using type = UndefinedProperty; };
 template<class TypeTag, class MyTypeTag>
@@ -294,6 +294,9 @@ public:
     SuperLU(const RealMatrix& matrix, int verb, bool reuse=true)
         : Base(reinterpret_cast<const Matrix&>(matrix), verb, reuse)
     {}
+
+    void setMatrix(const RealMatrix& matrix)
+    { Base::setMatrix(reinterpret_cast<const Matrix&>(matrix)); }
 };
 #endif
 
@@ -264,63 +264,48 @@ public:
     // communicates and adds up the contents of overlapping rows
     void syncAdd()
     {
-        // first, send all entries to the peers
-        const PeerSet& peerSet = overlap_->peerSet();
-        typename PeerSet::const_iterator peerIt = peerSet.begin();
-        typename PeerSet::const_iterator peerEndIt = peerSet.end();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-
-            sendEntries_(peerRank);
-        }
-
-        // then, receive entries from the peers
-        peerIt = peerSet.begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
+        syncBegin_();
+        syncEnd_(/*add=*/true);
+    }
 
-            receiveAddEntries_(peerRank);
-        }
+    /*!
+     * \brief Start to communicate the contents of the overlapping rows.
+     *
+     * The entries which are exchanged with the peers must not be modified until
+     * syncAddEnd() is called.
+     */
+    void syncAddBegin()
+    { syncBegin_(); }
 
-        // finally, make sure that everything which we send was
-        // received by the peers
-        peerIt = peerSet.begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-            entryValuesSendBuff_[peerRank]->wait();
-        }
-    }
+    /*!
+     * \brief Add up the contents of the overlapping rows which were received since
+     *        syncAddBegin() was called.
+     */
+    void syncAddEnd()
+    { syncEnd_(/*add=*/true); }
 
     // communicates and copies the contents of overlapping rows from
     // the master
     void syncCopy()
     {
-        // first, send all entries to the peers
-        const PeerSet& peerSet = overlap_->peerSet();
-        typename PeerSet::const_iterator peerIt = peerSet.begin();
-        typename PeerSet::const_iterator peerEndIt = peerSet.end();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-
-            sendEntries_(peerRank);
-        }
-
-        // then, receive entries from the peers
-        peerIt = peerSet.begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
+        syncBegin_();
+        syncEnd_(/*add=*/false);
+    }
 
-            receiveCopyEntries_(peerRank);
-        }
+    /*!
+     * \brief Start to communicate the contents of the overlapping rows.
+     *
+     * This is the first half of syncCopy().
+     */
+    void syncCopyBegin()
+    { syncBegin_(); }
 
-        // finally, make sure that everything which we send was
-        // received by the peers
-        peerIt = peerSet.begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-            entryValuesSendBuff_[peerRank]->wait();
-        }
-    }
+    /*!
+     * \brief Copy the contents of the overlapping rows which were received since
+     *        syncCopyBegin() was called.
+     */
+    void syncCopyEnd()
+    { syncEnd_(/*add=*/false); }
 
 private:
     template <class NativeBCRSMatrix>
@@ -402,6 +387,7 @@ private:
             globalToDomesticBuff_(*rowIndicesSendBuff_[peerRank]);
             globalToDomesticBuff_(*entryColIndicesSendBuff_[peerRank]);
         }
+        peerRanks_.assign(peerSet.begin(), peerSet.end());
 
         /////////
         // actually initialize the BCRS matrix structure
@@ -444,6 +430,59 @@ private:
 
         // free the memory occupied by the array of the matrix entries
         entries_.clear();
+
+        // the structure of the matrix is now fixed, so the matrix entries which are
+        // exchanged with the peers can be determined once and for all
+        buildEntryPointers_();
+    }
+
+    // determine the addresses of the matrix entries which are exchanged with each peer
+    // in the order in which they appear in the MPI buffers. this avoids looking up the
+    // entries by their row and column indices each time the matrix is syncronized.
+    void buildEntryPointers_()
+    {
+        size_t numPeers = peerRanks_.size();
+        sendEntryPtrs_.resize(numPeers);
+        recvEntryPtrs_.resize(numPeers);
+#if HAVE_MPI
+        recvRequests_.resize(numPeers);
+#endif // HAVE_MPI
+
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            ProcessRank peerRank = peerRanks_[peerIdx];
+
+            const auto& rowIndicesSendBuff = *rowIndicesSendBuff_[peerRank];
+            const auto& rowSizesSendBuff = *rowSizesSendBuff_[peerRank];
+            const auto& colIndicesSendBuff = *entryColIndicesSendBuff_[peerRank];
+            auto& sendEntryPtrs = sendEntryPtrs_[peerIdx];
+            sendEntryPtrs.resize(colIndicesSendBuff.size());
+            unsigned k = 0;
+            for (unsigned i = 0; i < rowIndicesSendBuff.size(); ++i) {
+                unsigned domRowIdx = static_cast<unsigned>(rowIndicesSendBuff[i]);
+                for (unsigned j = 0; j < rowSizesSendBuff[i]; ++j, ++k) {
+                    unsigned domColIdx = static_cast<unsigned>(colIndicesSendBuff[k]);
+                    sendEntryPtrs[k] = &(*this)[domRowIdx][domColIdx];
+                }
+            }
+
+            // entries which are not known locally are represented by null pointers
+            const auto& rowIndicesRecvBuff = *rowIndicesRecvBuff_[peerRank];
+            const auto& rowSizesRecvBuff = *rowSizesRecvBuff_[peerRank];
+            const auto& colIndicesRecvBuff = *entryColIndicesRecvBuff_[peerRank];
+            auto& recvEntryPtrs = recvEntryPtrs_[peerIdx];
+            recvEntryPtrs.resize(colIndicesRecvBuff.size());
+            k = 0;
+            for (unsigned i = 0; i < rowIndicesRecvBuff.size(); ++i) {
+                unsigned domRowIdx = static_cast<unsigned>(rowIndicesRecvBuff[i]);
+                for (unsigned j = 0; j < rowSizesRecvBuff[i]; ++j, ++k) {
+                    Index domColIdx = colIndicesRecvBuff[k];
+                    if (domColIdx < 0)
+                        recvEntryPtrs[k] = nullptr;
+                    else
+                        recvEntryPtrs[k] = &(*this)[domRowIdx][static_cast<unsigned>(domColIdx)];
+                }
+            }
+        }
     }
 
     // send the overlap indices to a peer
@@ -579,87 +618,90 @@ private:
 #endif // HAVE_MPI
     }
 
-    void sendEntries_(ProcessRank peerRank OPM_UNUSED_NOMPI)
+    // post the receive operations and send the overlapping entries to all peers
+    void syncBegin_()
     {
-#if HAVE_MPI
-        auto &mpiSendBuff = *entryValuesSendBuff_[peerRank];
-
-        auto &mpiRowIndicesSendBuff = *rowIndicesSendBuff_[peerRank];
-        auto &mpiRowSizesSendBuff = *rowSizesSendBuff_[peerRank];
-        auto &mpiColIndicesSendBuff = *entryColIndicesSendBuff_[peerRank];
-
-        // fill the send buffer
-        unsigned k = 0;
-        for (unsigned i = 0; i < mpiRowIndicesSendBuff.size(); ++i) {
-            Index domRowIdx = mpiRowIndicesSendBuff[i];
+        for (size_t peerIdx = 0; peerIdx < peerRanks_.size(); ++peerIdx) {
+            ProcessRank peerRank = peerRanks_[peerIdx];
+            entryValuesRecvBuff_[peerRank]->startReceive(peerRank);
+        }
 
-            for (Index j = 0; j < static_cast<Index>(mpiRowSizesSendBuff[i]); ++j)
-            {
-                // move to the next column which is in the overlap
-                Index domColIdx = mpiColIndicesSendBuff[k];
+        for (size_t peerIdx = 0; peerIdx < peerRanks_.size(); ++peerIdx)
+            sendEntries_(peerIdx);
+    }
 
-                // add the values of this column to the send buffer
-                mpiSendBuff[k] = (*this)[static_cast<unsigned>(domRowIdx)][static_cast<unsigned>(domColIdx)];
-                ++k;
-            }
+    // process the entries of the peers in the order in which they arrive, then make
+    // sure that everything which we sent was received by the peers
+    void syncEnd_(bool add OPM_UNUSED_NOMPI)
+    {
+#if HAVE_MPI
+        size_t numPeers = peerRanks_.size();
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx)
+            recvRequests_[peerIdx] = entryValuesRecvBuff_[peerRanks_[peerIdx]]->request();
+
+        for (size_t i = 0; i < numPeers; ++i) {
+            int peerIdx;
+            MPI_Waitany(static_cast<int>(numPeers),
+                        recvRequests_.data(),
+                        &peerIdx,
+                        MPI_STATUS_IGNORE);
+
+            if (add)
+                receiveAddEntries_(static_cast<size_t>(peerIdx));
+            else
+                receiveCopyEntries_(static_cast<size_t>(peerIdx));
         }
 
-        mpiSendBuff.send(peerRank);
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx)
+            entryValuesSendBuff_[peerRanks_[peerIdx]]->wait();
 #endif // HAVE_MPI
     }
 
-    void receiveAddEntries_(ProcessRank peerRank OPM_UNUSED_NOMPI)
+    void sendEntries_(size_t peerIdx OPM_UNUSED_NOMPI)
     {
 #if HAVE_MPI
-        auto &mpiRecvBuff = *entryValuesRecvBuff_[peerRank];
+        ProcessRank peerRank = peerRanks_[peerIdx];
+        auto &mpiSendBuff = *entryValuesSendBuff_[peerRank];
+
+        // fill the send buffer
+        const auto& sendEntryPtrs = sendEntryPtrs_[peerIdx];
+        for (unsigned k = 0; k < sendEntryPtrs.size(); ++k)
+            mpiSendBuff[k] = *sendEntryPtrs[k];
 
-        auto &mpiRowIndicesRecvBuff = *rowIndicesRecvBuff_[peerRank];
-        auto &mpiRowSizesRecvBuff = *rowSizesRecvBuff_[peerRank];
-        auto &mpiColIndicesRecvBuff = *entryColIndicesRecvBuff_[peerRank];
+        mpiSendBuff.send(peerRank);
+#endif // HAVE_MPI
+    }
 
-        mpiRecvBuff.receive(peerRank);
+    void receiveAddEntries_(size_t peerIdx OPM_UNUSED_NOMPI)
+    {
+#if HAVE_MPI
+        const auto &mpiRecvBuff = *entryValuesRecvBuff_[peerRanks_[peerIdx]];
 
         // retrieve the values from the receive buffer
-        unsigned k = 0;
-        for (unsigned i = 0; i < mpiRowIndicesRecvBuff.size(); ++i) {
-            Index domRowIdx = mpiRowIndicesRecvBuff[i];
-            for (unsigned j = 0; j < mpiRowSizesRecvBuff[i]; ++j, ++k) {
-                Index domColIdx = mpiColIndicesRecvBuff[k];
-
-                if (domColIdx < 0)
-                    // the matrix for the current process does not know about this DOF
-                    continue;
+        const auto& recvEntryPtrs = recvEntryPtrs_[peerIdx];
+        for (unsigned k = 0; k < recvEntryPtrs.size(); ++k) {
+            if (!recvEntryPtrs[k])
+                // the matrix for the current process does not know about this DOF
+                continue;
 
-                (*this)[static_cast<unsigned>(domRowIdx)][static_cast<unsigned>(domColIdx)] += mpiRecvBuff[k];
-            }
+            *recvEntryPtrs[k] += mpiRecvBuff[k];
         }
 #endif // HAVE_MPI
     }
 
-    void receiveCopyEntries_(int peerRank OPM_UNUSED_NOMPI)
+    void receiveCopyEntries_(size_t peerIdx OPM_UNUSED_NOMPI)
     {
 #if HAVE_MPI
-        MpiBuffer<block_type> &mpiRecvBuff = *entryValuesRecvBuff_[peerRank];
-
-        MpiBuffer<Index> &mpiRowIndicesRecvBuff = *rowIndicesRecvBuff_[peerRank];
-        MpiBuffer<unsigned> &mpiRowSizesRecvBuff = *rowSizesRecvBuff_[peerRank];
-        MpiBuffer<Index> &mpiColIndicesRecvBuff = *entryColIndicesRecvBuff_[peerRank];
-
-        mpiRecvBuff.receive(peerRank);
+        const auto &mpiRecvBuff = *entryValuesRecvBuff_[peerRanks_[peerIdx]];
 
         // retrieve the values from the receive buffer
-        unsigned k = 0;
-        for (unsigned i = 0; i < mpiRowIndicesRecvBuff.size(); ++i) {
-            Index domRowIdx = mpiRowIndicesRecvBuff[i];
-            for (unsigned j = 0; j < mpiRowSizesRecvBuff[i]; ++j, ++k) {
-                Index domColIdx = mpiColIndicesRecvBuff[k];
-
-                if (domColIdx < 0)
-                    // the matrix for the current process does not know about this DOF
-                    continue;
+        const auto& recvEntryPtrs = recvEntryPtrs_[peerIdx];
+        for (unsigned k = 0; k < recvEntryPtrs.size(); ++k) {
+            if (!recvEntryPtrs[k])
+                // the matrix for the current process does not know about this DOF
+                continue;
 
-                (*this)[static_cast<unsigned>(domRowIdx)][static_cast<unsigned>(domColIdx)] = mpiRecvBuff[k];
-            }
+            *recvEntryPtrs[k] = mpiRecvBuff[k];
         }
 #endif // HAVE_MPI
     }
@@ -685,6 +727,15 @@ private:
     std::map<ProcessRank, MpiBuffer<Index> *> rowIndicesRecvBuff_;
     std::map<ProcessRank, MpiBuffer<Index> *> entryColIndicesRecvBuff_;
     std::map<ProcessRank, MpiBuffer<block_type> *> entryValuesRecvBuff_;
+
+    // the ranks of the peers and, for each of them, the addresses of the matrix entries
+    // which are sent to and received from it
+    std::vector<ProcessRank> peerRanks_;
+    std::vector<std::vector<block_type*> > sendEntryPtrs_;
+    std::vector<std::vector<block_type*> > recvEntryPtrs_;
+#if HAVE_MPI
+    std::vector<MPI_Request> recvRequests_;
+#endif // HAVE_MPI
 };
 
 } // namespace Linear
@@ -36,8 +36,9 @@
 #include <dune/common/fvector.hh>
 
 #include <memory>
-#include <map>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 namespace Opm {
 namespace Linear {
@@ -65,13 +66,9 @@ public:
      */
     OverlappingBlockVector(const OverlappingBlockVector& obv)
         : ParentType(obv)
-        , numIndicesSendBuff_(obv.numIndicesSendBuff_)
-        , indicesSendBuff_(obv.indicesSendBuff_)
-        , indicesRecvBuff_(obv.indicesRecvBuff_)
-        , valuesSendBuff_(obv.valuesSendBuff_)
-        , valuesRecvBuff_(obv.valuesRecvBuff_)
+        , pattern_(obv.pattern_)
         , overlap_(obv.overlap_)
-    {}
+    { createValueBuffers_(); }
 
     /*!
      * \brief Default constructor.
@@ -92,11 +89,10 @@ public:
     OverlappingBlockVector& operator=(const OverlappingBlockVector& obv)
     {
         ParentType::operator=(obv);
-        numIndicesSendBuff_ = obv.numIndicesSendBuff_;
-        indicesSendBuff_ = obv.indicesSendBuff_;
-        indicesRecvBuff_ = obv.indicesRecvBuff_;
-        valuesSendBuff_ = obv.valuesSendBuff_;
-        valuesRecvBuff_ = obv.valuesRecvBuff_;
+        if (pattern_ != obv.pattern_) {
+            pattern_ = obv.pattern_;
+            createValueBuffers_();
+        }
         overlap_ = obv.overlap_;
         return *this;
     }
@@ -174,35 +170,60 @@ public:
      */
     void sync()
     {
-        // send all entries to all peers
-        for (const auto peerRank: overlap_->peerSet())
-            sendEntries_(peerRank);
+        syncBegin();
+        syncEnd();
+    }
 
-        // recieve all entries to the peers
-        for (const auto peerRank: overlap_->peerSet())
-            receiveFromMaster_(peerRank);
+    /*!
+     * \brief Start to syncronize the values of the block vector from their master
+     *        process.
+     *
+     * This posts the receive operations for the rows in the domestic overlap and sends
+     * the rows in the foreign overlap to the peers. Until syncEnd() is called, the rows
+     * in the foreign overlap must not be modified and the rows which are received from
+     * the peers must not be accessed.
+     */
+    void syncBegin()
+    {
+        // post the receive operations first so that the data of the peers can be
+        // received as soon as it arrives
+        startReceive_();
 
-        // wait until we have send everything
-        waitSendFinished_();
+        // send all entries to all peers
+        for (size_t peerIdx = 0; peerIdx < pattern_->peerRanks.size(); ++peerIdx)
+            sendEntries_(peerIdx);
     }
 
+    /*!
+     * \brief Finish the syncronization started by syncBegin().
+     */
+    void syncEnd()
+    { finishReceive_(/*add=*/false); }
+
     /*!
      * \brief Syncronize all values of the block vector by adding up
      *        the values of all peer ranks.
      */
     void syncAdd()
     {
-        // send all entries to all peers
-        for (const auto peerRank: overlap_->peerSet())
-            sendEntries_(peerRank);
+        syncAddBegin();
+        syncAddEnd();
+    }
 
-        // recieve all entries to the peers
-        for (const auto peerRank: overlap_->peerSet())
-            receiveAdd_(peerRank);
+    /*!
+     * \brief Start to syncronize the values of the block vector by adding up the
+     *        values of all peer ranks.
+     *
+     * The same restrictions as for syncBegin() apply until syncAddEnd() is called.
+     */
+    void syncAddBegin()
+    { syncBegin(); }
 
-        // wait until we have send everything
-        waitSendFinished_();
-    }
+    /*!
+     * \brief Finish the syncronization started by syncAddBegin().
+     */
+    void syncAddEnd()
+    { finishReceive_(/*add=*/true); }
 
     void print() const
     {
@@ -213,145 +234,189 @@ public:
     }
 
 private:
+    // the rows which are exchanged with the peers. This only depends on the overlap, so
+    // it is shared by all copies of a vector.
+    struct SyncPattern_
+    {
+        // the ranks of the peer processes
+        std::vector<ProcessRank> peerRanks;
+
+        // for each peer, the domestic indices of the rows which are sent to it and of
+        // the rows which are received from it
+        std::vector<std::vector<unsigned> > sendRows;
+        std::vector<std::vector<unsigned> > recvRows;
+
+        // for each peer, the positions in the receive buffer and the domestic indices of
+        // the received rows for which the peer is the master process
+        std::vector<std::vector<std::pair<unsigned, unsigned> > > masterRecvRows;
+    };
+
     void createBuffers_()
     {
+        auto pattern = std::make_shared<SyncPattern_>();
+        pattern->peerRanks.assign(overlap_->peerSet().begin(), overlap_->peerSet().end());
+        size_t numPeers = pattern->peerRanks.size();
+        pattern->sendRows.resize(numPeers);
+        pattern->recvRows.resize(numPeers);
+        pattern->masterRecvRows.resize(numPeers);
+
 #if HAVE_MPI
-        // create array for the front indices
-        typename PeerSet::const_iterator peerIt;
-        typename PeerSet::const_iterator peerEndIt = overlap_->peerSet().end();
+        std::vector<std::shared_ptr<MpiBuffer<unsigned> > > numIndicesSendBuff(numPeers);
+        std::vector<std::shared_ptr<MpiBuffer<Index> > > indicesSendBuff(numPeers);
 
         // send all indices to the peers
-        peerIt = overlap_->peerSet().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            ProcessRank peerRank = pattern->peerRanks[peerIdx];
 
             size_t numEntries = overlap_->foreignOverlapSize(peerRank);
-            numIndicesSendBuff_[peerRank] = std::make_shared<MpiBuffer<unsigned> >(1);
-            indicesSendBuff_[peerRank] = std::make_shared<MpiBuffer<Index> >(numEntries);
-            valuesSendBuff_[peerRank] = std::make_shared<MpiBuffer<FieldVector> >(numEntries);
+            numIndicesSendBuff[peerIdx] = std::make_shared<MpiBuffer<unsigned> >(1);
+            indicesSendBuff[peerIdx] = std::make_shared<MpiBuffer<Index> >(numEntries);
 
-            // fill the indices buffer with global indices
-            MpiBuffer<Index>& indicesSendBuff = *indicesSendBuff_[peerRank];
+            // fill the indices buffer with global indices and remember the domestic ones
+            MpiBuffer<Index>& indices = *indicesSendBuff[peerIdx];
+            auto& sendRows = pattern->sendRows[peerIdx];
+            sendRows.resize(numEntries);
             for (unsigned i = 0; i < numEntries; ++i) {
                 Index domRowIdx = overlap_->foreignOverlapOffsetToDomesticIdx(peerRank, i);
-                indicesSendBuff[i] = overlap_->domesticToGlobal(domRowIdx);
+                sendRows[i] = static_cast<unsigned>(domRowIdx);
+                indices[i] = overlap_->domesticToGlobal(domRowIdx);
             }
 
             // first, send the number of indices
-            (*numIndicesSendBuff_[peerRank])[0] = static_cast<unsigned>(numEntries);
-            numIndicesSendBuff_[peerRank]->send(peerRank);
+            (*numIndicesSendBuff[peerIdx])[0] = static_cast<unsigned>(numEntries);
+            numIndicesSendBuff[peerIdx]->send(peerRank);
 
             // then, send the indices themselfs
-            indicesSendBuff.send(peerRank);
+            indices.send(peerRank);
         }
 
         // receive the indices from the peers
-        peerIt = overlap_->peerSet().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            ProcessRank peerRank = pattern->peerRanks[peerIdx];
 
             // receive size of overlap to peer
             MpiBuffer<unsigned> numRowsRecvBuff(1);
             numRowsRecvBuff.receive(peerRank);
             unsigned numRows = numRowsRecvBuff[0];
 
-            // then, create the MPI buffers
-            indicesRecvBuff_[peerRank] = std::shared_ptr<MpiBuffer<Index> >(
-                new MpiBuffer<Index>(numRows));
-            valuesRecvBuff_[peerRank] = std::shared_ptr<MpiBuffer<FieldVector> >(
-                new MpiBuffer<FieldVector>(numRows));
-            MpiBuffer<Index>& indicesRecvBuff = *indicesRecvBuff_[peerRank];
-
             // next, receive the actual indices
+            MpiBuffer<Index> indicesRecvBuff(numRows);
             indicesRecvBuff.receive(peerRank);
 
             // finally, translate the global indices to domestic ones
+            auto& recvRows = pattern->recvRows[peerIdx];
+            auto& masterRecvRows = pattern->masterRecvRows[peerIdx];
+            recvRows.resize(numRows);
             for (unsigned i = 0; i != numRows; ++i) {
-                Index globalRowIdx = indicesRecvBuff[i];
-                Index domRowIdx = overlap_->globalToDomestic(globalRowIdx);
+                Index domRowIdx = overlap_->globalToDomestic(indicesRecvBuff[i]);
+                recvRows[i] = static_cast<unsigned>(domRowIdx);
 
-                indicesRecvBuff[i] = domRowIdx;
+                if (overlap_->masterRank(domRowIdx) == peerRank)
+                    masterRecvRows.emplace_back(i, static_cast<unsigned>(domRowIdx));
             }
         }
 
         // wait for all send operations to complete
-        peerIt = overlap_->peerSet().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-            numIndicesSendBuff_[peerRank]->wait();
-            indicesSendBuff_[peerRank]->wait();
-
-            // convert the global indices of the send buffer to
-            // domestic ones
-            MpiBuffer<Index>& indicesSendBuff = *indicesSendBuff_[peerRank];
-            for (unsigned i = 0; i < indicesSendBuff.size(); ++i) {
-                indicesSendBuff[i] = overlap_->globalToDomestic(indicesSendBuff[i]);
-            }
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            numIndicesSendBuff[peerIdx]->wait();
+            indicesSendBuff[peerIdx]->wait();
         }
 #endif // HAVE_MPI
+
+        pattern_ = pattern;
+        createValueBuffers_();
     }
 
-    void sendEntries_(ProcessRank peerRank)
+    // allocate the buffers for the values which are exchanged with the peers. These are
+    // not shared between copies of a vector so that each of them can be syncronized
+    // independently.
+    void createValueBuffers_()
     {
-        // copy the values into the send buffer
-        const MpiBuffer<Index>& indices = *indicesSendBuff_[peerRank];
-        MpiBuffer<FieldVector>& values = *valuesSendBuff_[peerRank];
-        for (unsigned i = 0; i < indices.size(); ++i)
-            values[i] = (*this)[static_cast<unsigned>(indices[i])];
-
-        values.send(peerRank);
+        size_t numPeers = pattern_ ? pattern_->peerRanks.size() : 0;
+        valuesSendBuff_.resize(numPeers);
+        valuesRecvBuff_.resize(numPeers);
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx) {
+            valuesSendBuff_[peerIdx] =
+                std::make_shared<MpiBuffer<FieldVector> >(pattern_->sendRows[peerIdx].size());
+            valuesRecvBuff_[peerIdx] =
+                std::make_shared<MpiBuffer<FieldVector> >(pattern_->recvRows[peerIdx].size());
+        }
+#if HAVE_MPI
+        recvRequests_.resize(numPeers);
+#endif // HAVE_MPI
     }
 
-    void waitSendFinished_()
+    void startReceive_()
     {
-        typename PeerSet::const_iterator peerIt;
-        typename PeerSet::const_iterator peerEndIt = overlap_->peerSet().end();
-
-        // send all entries to all peers
-        peerIt = overlap_->peerSet().begin();
-        for (; peerIt != peerEndIt; ++peerIt) {
-            ProcessRank peerRank = *peerIt;
-            valuesSendBuff_[peerRank]->wait();
-        }
+        for (size_t peerIdx = 0; peerIdx < pattern_->peerRanks.size(); ++peerIdx)
+            valuesRecvBuff_[peerIdx]->startReceive(pattern_->peerRanks[peerIdx]);
     }
 
-    void receiveFromMaster_(ProcessRank peerRank)
+    void sendEntries_(size_t peerIdx)
     {
-        const MpiBuffer<Index>& indices = *indicesRecvBuff_[peerRank];
-        MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerRank];
+        // copy the values into the send buffer
+        const auto& rows = pattern_->sendRows[peerIdx];
+        MpiBuffer<FieldVector>& values = *valuesSendBuff_[peerIdx];
+        for (unsigned i = 0; i < rows.size(); ++i)
+            values[i] = (*this)[rows[i]];
 
-        // receive the values from the peer
-        values.receive(peerRank);
+        values.send(pattern_->peerRanks[peerIdx]);
+    }
 
-        // copy them into the block vector
-        for (unsigned j = 0; j < indices.size(); ++j) {
-            Index domRowIdx = indices[j];
-            if (overlap_->masterRank(domRowIdx) == peerRank) {
-                (*this)[static_cast<unsigned>(domRowIdx)] = values[j];
-            }
+    // process the data of the peers in the order in which it arrives, then wait until
+    // everything has been sent
+    void finishReceive_(bool add OPM_UNUSED_NOMPI)
+    {
+#if HAVE_MPI
+        size_t numPeers = pattern_->peerRanks.size();
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx)
+            recvRequests_[peerIdx] = valuesRecvBuff_[peerIdx]->request();
+
+        for (size_t i = 0; i < numPeers; ++i) {
+            int peerIdx;
+            MPI_Waitany(static_cast<int>(numPeers),
+                        recvRequests_.data(),
+                        &peerIdx,
+                        MPI_STATUS_IGNORE);
+
+            if (add)
+                receiveAdd_(static_cast<size_t>(peerIdx));
+            else
+                receiveFromMaster_(static_cast<size_t>(peerIdx));
         }
+
+        for (size_t peerIdx = 0; peerIdx < numPeers; ++peerIdx)
+            valuesSendBuff_[peerIdx]->wait();
+#endif // HAVE_MPI
     }
 
-    void receiveAdd_(ProcessRank peerRank)
+    void receiveFromMaster_(size_t peerIdx)
     {
-        const MpiBuffer<Index>& indices = *indicesRecvBuff_[peerRank];
-        MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerRank];
+        const auto& rows = pattern_->masterRecvRows[peerIdx];
+        const MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerIdx];
 
-        // receive the values from the peer
-        values.receive(peerRank);
+        // copy the values of the rows of which the peer is the master into the block
+        // vector
+        for (const auto& row : rows)
+            (*this)[row.second] = values[row.first];
+    }
+
+    void receiveAdd_(size_t peerIdx)
+    {
+        const auto& rows = pattern_->recvRows[peerIdx];
+        const MpiBuffer<FieldVector>& values = *valuesRecvBuff_[peerIdx];
 
         // add up the values of rows on the shared boundary
-        for (unsigned j = 0; j < indices.size(); ++j) {
-            Index domRowIdx = indices[j];
-            (*this)[static_cast<unsigned>(domRowIdx)] += values[j];
-        }
+        for (unsigned j = 0; j < rows.size(); ++j)
+            (*this)[rows[j]] += values[j];
     }
 
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<unsigned> > > numIndicesSendBuff_;
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<Index> > > indicesSendBuff_;
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<Index> > > indicesRecvBuff_;
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<FieldVector> > > valuesSendBuff_;
-    std::map<ProcessRank, std::shared_ptr<MpiBuffer<FieldVector> > > valuesRecvBuff_;
+    std::shared_ptr<const SyncPattern_> pattern_;
+    std::vector<std::shared_ptr<MpiBuffer<FieldVector> > > valuesSendBuff_;
+    std::vector<std::shared_ptr<MpiBuffer<FieldVector> > > valuesRecvBuff_;
+#if HAVE_MPI
+    std::vector<MPI_Request> recvRequests_;
+#endif // HAVE_MPI
 
     const Overlap *overlap_;
 };
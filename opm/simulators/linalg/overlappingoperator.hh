@@ -30,11 +30,17 @@
 #include <dune/istl/operators.hh>
 #include <dune/common/version.hh>
 
+#include <vector>
+
 namespace Opm {
 namespace Linear {
 
 /*!
  * \brief An overlap aware linear operator usable by ISTL.
+ *
+ * The rows of the result which must be sent to the peer processes are computed first.
+ * Then the syncronization of the result is started and the remaining rows are computed
+ * while the data is in flight.
  */
 template <class OverlappingMatrix, class DomainVector, class RangeVector>
 class OverlappingOperator
@@ -48,7 +54,23 @@ public:
     using field_type = typename domain_type::field_type;
 
     OverlappingOperator(const OverlappingMatrix& A) : A_(A)
-    {}
+    {
+        // sort the rows into the ones which are sent to at least one peer and all others
+        const Overlap& overlap = A.overlap();
+        std::vector<bool> isSendRow(A.N(), false);
+        for (const auto peerRank : overlap.peerSet()) {
+            size_t numRows = overlap.foreignOverlapSize(peerRank);
+            for (unsigned i = 0; i < numRows; ++i)
+                isSendRow[static_cast<size_t>(overlap.foreignOverlapOffsetToDomesticIdx(peerRank, i))] = true;
+        }
+
+        for (unsigned rowIdx = 0; rowIdx < A.N(); ++rowIdx) {
+            if (isSendRow[rowIdx])
+                sendRows_.push_back(rowIdx);
+            else
+                interiorRows_.push_back(rowIdx);
+        }
+    }
 
     //! the kind of computations supported by the operator. Either overlapping or non-overlapping
     Dune::SolverCategory::Category category() const override
@@ -57,16 +79,20 @@ public:
     //! apply operator to x:  \f$ y = A(x) \f$
     virtual void apply(const DomainVector& x, RangeVector& y) const override
     {
-        A_.mv(x, y);
-        y.sync();
+        mv_(x, y, sendRows_);
+        y.syncBegin();
+        mv_(x, y, interiorRows_);
+        y.syncEnd();
     }
 
     //! apply operator to x, scale and add:  \f$ y = y + \alpha A(x) \f$
     virtual void applyscaleadd(field_type alpha, const DomainVector& x,
                                RangeVector& y) const override
     {
-        A_.usmv(alpha, x, y);
-        y.sync();
+        usmv_(alpha, x, y, sendRows_);
+        y.syncBegin();
+        usmv_(alpha, x, y, interiorRows_);
+        y.syncEnd();
     }
 
     //! returns the matrix
@@ -77,7 +103,43 @@ public:
     { return A_.overlap(); }
 
 private:
+    // y_i = (A x)_i for all rows i of a list
+    void mv_(const DomainVector& x, RangeVector& y, const std::vector<unsigned>& rows) const
+    {
+        for (unsigned rowIdx : rows) {
+            auto& yRow = y[rowIdx];
+            yRow = 0.0;
+
+            const auto& row = A_[rowIdx];
+            auto colIt = row.begin();
+            const auto& colEndIt = row.end();
+            for (; colIt != colEndIt; ++colIt)
+                colIt->umv(x[colIt.index()], yRow);
+        }
+    }
+
+    // y_i += alpha (A x)_i for all rows i of a list
+    void usmv_(field_type alpha,
+               const DomainVector& x,
+               RangeVector& y,
+               const std::vector<unsigned>& rows) const
+    {
+        for (unsigned rowIdx : rows) {
+            auto& yRow = y[rowIdx];
+
+            const auto& row = A_[rowIdx];
+            auto colIt = row.begin();
+            const auto& colEndIt = row.end();
+            for (; colIt != colEndIt; ++colIt)
+                colIt->usmv(alpha, x[colIt.index()], yRow);
+        }
+    }
+
     const OverlappingMatrix& A_;
+
+    // the rows of the result which are sent to the peer processes and all others
+    std::vector<unsigned> sendRows_;
+    std::vector<unsigned> interiorRows_;
 };
 
 } // namespace Linear
@@ -31,6 +31,9 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/istl/scalarproducts.hh>
 
+#include <array>
+#include <cstddef>
+
 namespace Opm {
 namespace Linear {
 
@@ -74,6 +77,32 @@ public:
         return comm_.sum( sum );
     }
 
+    /*!
+     * \brief Compute several scalar products at once.
+     *
+     * The result is the same as calling dot(*x[i], *y[i]) for each i, but the vectors
+     * are only traversed once and only a single global reduction is required.
+     */
+    template <std::size_t N>
+    std::array<field_type, N> dots(const std::array<const OverlappingBlockVector*, N>& x,
+                                   const std::array<const OverlappingBlockVector*, N>& y) const
+    {
+        std::array<field_type, N> sums;
+        sums.fill(0.0);
+
+        size_t numLocal = overlap_.numLocal();
+        for (unsigned localIdx = 0; localIdx < numLocal; ++localIdx) {
+            if (overlap_.iAmMasterOf(static_cast<int>(localIdx))) {
+                for (std::size_t i = 0; i < N; ++i)
+                    sums[i] += (*x[i])[localIdx] * (*y[i])[localIdx];
+            }
+        }
+
+        // return the global sums
+        comm_.sum(sums.data(), static_cast<int>(N));
+        return sums;
+    }
+
 #if DUNE_VERSION_NEWER(DUNE_ISTL, 2,7)
     real_type norm(const OverlappingBlockVector& x) const override
 #else
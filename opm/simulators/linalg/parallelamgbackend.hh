@@ -40,6 +40,7 @@
 
 #include <dune/common/version.hh>
 
+#include <algorithm>
 #include <iostream>
 
 namespace Opm::Linear {
@@ -59,6 +60,22 @@ struct ParallelAmgLinearSolver { using InheritsFrom = std::tuple<ParallelBaseLin
 template<class TypeTag>
 struct AmgCoarsenTarget<TypeTag, TTag::ParallelAmgLinearSolver> { static constexpr int value = 5000; };
 
+//! Set up the AMG from scratch for each linear solve by default
+template<class TypeTag>
+struct AmgReuseHierarchy<TypeTag, TTag::ParallelAmgLinearSolver> { static constexpr bool value = false; };
+
+//! If the hierarchy is reused, do a full setup at least every 20 linear solves
+template<class TypeTag>
+struct AmgMaxHierarchyReuses<TypeTag, TTag::ParallelAmgLinearSolver> { static constexpr int value = 20; };
+
+//! If the hierarchy is reused, do a full setup if the number of iterations doubles
+template<class TypeTag>
+struct AmgReuseIterationGrowth<TypeTag, TTag::ParallelAmgLinearSolver>
+{
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 2.0;
+};
+
 template<class TypeTag>
 struct LinearSolverMaxError<TypeTag, TTag::ParallelAmgLinearSolver>
 {
@@ -66,6 +83,10 @@ struct LinearSolverMaxError<TypeTag, TTag::ParallelAmgLinearSolver>
     static constexpr type value = 1e7;
 };
 
+//! Compute each scalar product of the BiCGStab solver using a separate reduction by default
+template<class TypeTag>
+struct LinearSolverFuseReductions<TypeTag, TTag::ParallelAmgLinearSolver> { static constexpr bool value = false; };
+
 template<class TypeTag>
 struct LinearSolverBackend<TypeTag, TTag::ParallelAmgLinearSolver>
 { using type = Opm::Linear::ParallelAmgBackend<TypeTag>; };
@@ -79,6 +100,15 @@ namespace Linear {
  *
  * \brief Provides a linear solver backend using the parallel
  *        algebraic multi-grid (AMG) linear solver from DUNE-ISTL.
+ *
+ * The communication objects and the fine level operator are kept as long as the
+ * topology of the linear system does not change. If the AmgReuseHierarchy parameter is
+ * set, the aggregates of the AMG are kept as well and only the coarse level operators,
+ * the smoothers and the coarse solver are recomputed for the new values of the fine
+ * level matrix. A full setup is done after AmgMaxHierarchyReuses linear solves, if the
+ * number of linear iterations has grown by more than a factor of
+ * AmgReuseIterationGrowth compared to the first solve after the last full setup or if
+ * the linear solver did not converge.
  */
 template <class TypeTag>
 class ParallelAmgBackend : public ParallelBaseBackend<TypeTag>
@@ -141,7 +171,8 @@ class ParallelAmgBackend : public ParallelBaseBackend<TypeTag>
 
     using RawLinearSolver = BiCGStabSolver<ParallelOperator,
                                            OverlappingVector,
-                                           AMG> ;
+                                           AMG,
+                                           ParallelScalarProduct>;
 
     static_assert(std::is_same<SparseMatrixAdapter, IstlSparseMatrixAdapter<MatrixBlock> >::value,
                   "The ParallelAmgBackend linear solver backend requires the IstlSparseMatrixAdapter");
@@ -149,6 +180,9 @@ class ParallelAmgBackend : public ParallelBaseBackend<TypeTag>
 public:
     ParallelAmgBackend(const Simulator& simulator)
         : ParentType(simulator)
+        , numHierarchyReuses_(0)
+        , setupIterations_(0)
+        , forceSetup_(true)
     { }
 
     static void registerParameters()
@@ -158,32 +192,78 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, LinearSolverMaxError,
                              "The maximum residual error which the linear solver tolerates"
                              " without giving up");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverFuseReductions,
+                             "Compute the scalar products at the end of a BiCGStab iteration "
+                             "using a single global reduction");
         EWOMS_REGISTER_PARAM(TypeTag, int, AmgCoarsenTarget,
                              "The coarsening target for the agglomerations of "
                              "the AMG preconditioner");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, AmgReuseHierarchy,
+                             "Keep the aggregates of the AMG preconditioner across linear "
+                             "solves and only recompute the coarse level operators");
+        EWOMS_REGISTER_PARAM(TypeTag, int, AmgMaxHierarchyReuses,
+                             "The maximum number of linear solves between two full setups "
+                             "of the AMG preconditioner if the hierarchy is reused "
+                             "('0' means 'unlimited')");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, AmgReuseIterationGrowth,
+                             "Fully set up the AMG preconditioner again if the number of "
+                             "linear iterations grows by more than this factor while the "
+                             "hierarchy is reused ('0' means 'never')");
     }
 
 protected:
     friend ParentType;
 
-    std::shared_ptr<AMG> preparePreconditioner_()
+    void cleanup_()
     {
+        // the AMG, the fine operator and the communication object refer to the
+        // overlapping matrix, so they must go away before it
+        amg_.reset();
+        fineOperator_.reset();
 #if HAVE_MPI
-        // create and initialize DUNE's OwnerOverlapCopyCommunication
-        // using the domestic overlap
-        istlComm_ = std::make_shared<OwnerOverlapCopyCommunication>(MPI_COMM_WORLD);
-        setupAmgIndexSet_(this->overlappingMatrix_->overlap(), istlComm_->indexSet());
-        istlComm_->remoteIndices().template rebuild<false>();
+        istlComm_.reset();
 #endif
+        forceSetup_ = true;
 
-        // create the parallel scalar product and the parallel operator
+        ParentType::cleanup_();
+    }
+
+    std::shared_ptr<AMG> preparePreconditioner_()
+    {
+        // the communication object and the fine operator only depend on the topology of
+        // the overlapping matrix, i.e., they only need to be re-created if the
+        // overlapping matrix has been re-created.
+        if (!fineOperator_) {
 #if HAVE_MPI
-        fineOperator_ = std::make_shared<FineOperator>(*this->overlappingMatrix_, *istlComm_);
+            // create and initialize DUNE's OwnerOverlapCopyCommunication
+            // using the domestic overlap
+            istlComm_ = std::make_shared<OwnerOverlapCopyCommunication>(MPI_COMM_WORLD);
+            setupAmgIndexSet_(this->overlappingMatrix_->overlap(), istlComm_->indexSet());
+            istlComm_->remoteIndices().template rebuild<false>();
+
+            fineOperator_ = std::make_shared<FineOperator>(*this->overlappingMatrix_, *istlComm_);
 #else
-        fineOperator_ = std::make_shared<FineOperator>(*this->overlappingMatrix_);
+            fineOperator_ = std::make_shared<FineOperator>(*this->overlappingMatrix_);
 #endif
+        }
 
-        setupAmg_();
+        // the matrix has not been modified since the last solve, so the preconditioner
+        // can be used as it is
+        if (amg_ && !this->matrixChanged_ && !forceSetup_)
+            return amg_;
+
+        if (!reuseHierarchy_()) {
+            setupAmg_();
+            numHierarchyReuses_ = 0;
+            forceSetup_ = false;
+        }
+        else {
+            // keep the aggregates and only recompute the Galerkin products of the
+            // coarse levels, the smoothers and the coarse solver
+            amg_->update();
+            ++numHierarchyReuses_;
+        }
+        this->matrixChanged_ = false;
 
         return amg_;
     }
@@ -216,6 +296,7 @@ protected:
             verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
         bicgstabSolver->setVerbosity(verbosity);
         bicgstabSolver->setMaxIterations(EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations));
+        bicgstabSolver->setFuseReductions(EWOMS_GET_PARAM(TypeTag, bool, LinearSolverFuseReductions));
         bicgstabSolver->setLinearOperator(&parOperator);
         bicgstabSolver->setRhs(this->overlappingb_);
 
@@ -225,7 +306,21 @@ protected:
     std::pair<bool,int> runSolver_(std::shared_ptr<RawLinearSolver> solver)
     {
         bool converged = solver->apply(*this->overlappingx_);
-        return std::make_pair(converged, int(solver->report().iterations()));
+        int iterations = static_cast<int>(solver->report().iterations());
+
+        // decide whether the hierarchy can be kept for the next solve. since the
+        // convergence behaviour of the linear solver is the same on all ranks, so is
+        // this decision.
+        Scalar growth = EWOMS_GET_PARAM(TypeTag, Scalar, AmgReuseIterationGrowth);
+        if (numHierarchyReuses_ == 0)
+            setupIterations_ = iterations;
+        else if (growth > 0.0 && iterations > growth*std::max(setupIterations_, 1))
+            forceSetup_ = true;
+
+        if (!converged)
+            forceSetup_ = true;
+
+        return std::make_pair(converged, iterations);
     }
 
     void cleanupSolver_()
@@ -260,6 +355,21 @@ protected:
     }
 #endif
 
+    bool reuseHierarchy_() const
+    {
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2,7)
+        if (!amg_ || forceSetup_ || !EWOMS_GET_PARAM(TypeTag, bool, AmgReuseHierarchy))
+            return false;
+
+        int maxReuses = EWOMS_GET_PARAM(TypeTag, int, AmgMaxHierarchyReuses);
+        return maxReuses <= 0 || numHierarchyReuses_ < maxReuses;
+#else
+        // older versions of dune-istl cannot update the smoothers and the coarse solver
+        // of an existing hierarchy
+        return false;
+#endif
+    }
+
     void setupAmg_()
     {
         if (amg_)
@@ -310,6 +420,10 @@ protected:
     std::shared_ptr<FineOperator> fineOperator_;
     std::shared_ptr<AMG> amg_;
 
+    int numHierarchyReuses_;
+    int setupIterations_;
+    bool forceSetup_;
+
 #if HAVE_MPI
     std::shared_ptr<OwnerOverlapCopyCommunication> istlComm_;
 #endif
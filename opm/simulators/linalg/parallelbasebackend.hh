@@ -38,6 +38,7 @@
 
 #include <opm/models/utils/genericguard.hh>
 #include <opm/models/utils/propertysystem.hh>
+#include <opm/models/utils/profiler.hh>
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/simulators/linalg/matrixblock.hh>
 #include <opm/simulators/linalg/linalgproperties.hh>
@@ -107,6 +108,7 @@ class ParallelBaseBackend
 {
 protected:
     using Implementation = GetPropType<TypeTag, Properties::LinearSolverBackend>;
+    using Profiler = Opm::Profiler<TypeTag>;
 
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
@@ -140,6 +142,9 @@ public:
         overlappingMatrix_ = nullptr;
         overlappingb_ = nullptr;
         overlappingx_ = nullptr;
+
+        matrixChanged_ = true;
+        preconditionerIsPrepared_ = false;
     }
 
     ~ParallelBaseBackend()
@@ -234,12 +239,14 @@ public:
      * \brief Sets the values of the residual's Jacobian matrix.
      *
      * This method also synchronizes the data structure across the processes which are
-     * involved in the simulation run.
+     * involved in the simulation run. If this method is not called between two calls
+     * to solve(), the preconditioner of the previous solve is reused.
      */
     void setMatrix(const SparseMatrixAdapter& M)
     {
         overlappingMatrix_->assignFromNative(M.istlMatrix());
         overlappingMatrix_->syncAdd();
+        matrixChanged_ = true;
     }
 
     /*!
@@ -249,6 +256,8 @@ public:
      */
     bool solve(Vector& x)
     {
+        typename Profiler::Scope profilerScope(Profiler::LinearSolve);
+
 #if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,7)
         Dune::FMatrixPrecision<LinearSolverScalar>::set_singular_limit(1.e-30);
         Dune::FMatrixPrecision<LinearSolverScalar>::set_absolute_limit(1.e-30);
@@ -256,7 +265,11 @@ public:
 
         (*overlappingx_) = 0.0;
 
-        auto parPreCond = asImp_().preparePreconditioner_();
+        decltype(asImp_().preparePreconditioner_()) parPreCond;
+        {
+            typename Profiler::Scope precondProfilerScope(Profiler::PreconditionerSetup);
+            parPreCond = asImp_().preparePreconditioner_();
+        }
         auto precondCleanupFn = [this]() -> void
                                 { this->asImp_().cleanupPreconditioner_(); };
         auto precondCleanupGuard = Opm::make_guard(precondCleanupFn);
@@ -275,7 +288,11 @@ public:
         GenericGuard<decltype(cleanupSolverFn)> solverGuard(cleanupSolverFn);
 
         // run the linear solver and have some fun
-        auto result = asImp_().runSolver_(solver);
+        decltype(asImp_().runSolver_(solver)) result;
+        {
+            typename Profiler::Scope solverProfilerScope(Profiler::KrylovIterations);
+            result = asImp_().runSolver_(solver);
+        }
         // store number of iterations used
         lastIterations_ = result.second;
 
@@ -301,6 +318,13 @@ protected:
 
     void cleanup_()
     {
+        // the sequential preconditioner refers to the overlapping matrix
+        if (preconditionerIsPrepared_) {
+            precWrapper_.cleanup();
+            preconditionerIsPrepared_ = false;
+        }
+        matrixChanged_ = true;
+
         // create the overlapping Jacobian matrix and vectors
         delete overlappingMatrix_;
         delete overlappingb_;
@@ -313,23 +337,36 @@ protected:
 
     std::shared_ptr<ParallelPreconditioner> preparePreconditioner_()
     {
-        int preconditionerIsReady = 1;
-        try {
-            // update sequential preconditioner
-            precWrapper_.prepare(*overlappingMatrix_);
-        }
-        catch (const Dune::Exception& e) {
-            std::cout << "Preconditioner threw exception \"" << e.what()
-                      << " on rank " << overlappingMatrix_->overlap().myRank()
-                      << "\n"  << std::flush;
-            preconditionerIsReady = 0;
-        }
+        // the sequential preconditioner only needs to be set up again if the matrix has
+        // been modified since the last solve. since setMatrix() is called by all ranks,
+        // this decision is the same on all of them.
+        if (matrixChanged_ || !preconditionerIsPrepared_) {
+            if (preconditionerIsPrepared_) {
+                precWrapper_.cleanup();
+                preconditionerIsPrepared_ = false;
+            }
+
+            int preconditionerIsReady = 1;
+            try {
+                // update sequential preconditioner
+                precWrapper_.prepare(*overlappingMatrix_);
+                preconditionerIsPrepared_ = true;
+            }
+            catch (const Dune::Exception& e) {
+                std::cout << "Preconditioner threw exception \"" << e.what()
+                          << " on rank " << overlappingMatrix_->overlap().myRank()
+                          << "\n"  << std::flush;
+                preconditionerIsReady = 0;
+            }
 
-        // make sure that the preconditioner is also ready on all peer
-        // ranks.
-        preconditionerIsReady = simulator_.gridView().comm().min(preconditionerIsReady);
-        if (!preconditionerIsReady)
-            throw Opm::NumericalIssue("Creating the preconditioner failed");
+            // make sure that the preconditioner is also ready on all peer
+            // ranks.
+            preconditionerIsReady = simulator_.gridView().comm().min(preconditionerIsReady);
+            if (!preconditionerIsReady)
+                throw Opm::NumericalIssue("Creating the preconditioner failed");
+
+            matrixChanged_ = false;
+        }
 
         // create the parallel preconditioner
         return std::make_shared<ParallelPreconditioner>(precWrapper_.get(), overlappingMatrix_->overlap());
@@ -337,7 +374,8 @@ protected:
 
     void cleanupPreconditioner_()
     {
-        precWrapper_.cleanup();
+        // the sequential preconditioner is kept until the matrix is modified or the
+        // overlapping matrix is destroyed, see cleanup_()
     }
 
     void writeOverlapToVTK_()
@@ -386,6 +424,10 @@ protected:
     OverlappingVector *overlappingx_;
 
     PreconditionerWrapper precWrapper_;
+
+    // true if the matrix was assigned since the preconditioner was set up
+    bool matrixChanged_;
+    bool preconditionerIsPrepared_;
 };
 }} // namespace Linear, Opm
 
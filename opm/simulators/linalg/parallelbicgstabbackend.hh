@@ -58,6 +58,10 @@ struct LinearSolverMaxError<TypeTag, TTag::ParallelBiCGStabLinearSolver>
     static constexpr type value = 1e7;
 };
 
+//! Compute each scalar product of the BiCGStab solver using a separate reduction by default
+template<class TypeTag>
+struct LinearSolverFuseReductions<TypeTag, TTag::ParallelBiCGStabLinearSolver> { static constexpr bool value = false; };
+
 } // namespace Opm::Properties
 
 namespace Opm {
@@ -107,7 +111,8 @@ class ParallelBiCGStabSolverBackend : public ParallelBaseBackend<TypeTag>
 
     using RawLinearSolver = BiCGStabSolver<ParallelOperator,
                                            OverlappingVector,
-                                           ParallelPreconditioner>;
+                                           ParallelPreconditioner,
+                                           ParallelScalarProduct>;
 
     static_assert(std::is_same<SparseMatrixAdapter, IstlSparseMatrixAdapter<MatrixBlock> >::value,
                   "The ParallelIstlSolverBackend linear solver backend requires the IstlSparseMatrixAdapter");
@@ -124,6 +129,9 @@ public:
         EWOMS_REGISTER_PARAM(TypeTag, Scalar, LinearSolverMaxError,
                              "The maximum residual error which the linear solver tolerates"
                              " without giving up");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverFuseReductions,
+                             "Compute the scalar products at the end of a BiCGStab iteration "
+                             "using a single global reduction");
     }
 
 protected:
@@ -154,6 +162,7 @@ protected:
             verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
         bicgstabSolver->setVerbosity(verbosity);
         bicgstabSolver->setMaxIterations(EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations));
+        bicgstabSolver->setFuseReductions(EWOMS_GET_PARAM(TypeTag, bool, LinearSolverFuseReductions));
         bicgstabSolver->setLinearOperator(&parOperator);
         bicgstabSolver->setRhs(this->overlappingb_);
 
@@ -0,0 +1,219 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Linear::SparsityPattern
+ */
+#ifndef EWOMS_SPARSITY_PATTERN_HH
+#define EWOMS_SPARSITY_PATTERN_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Opm {
+namespace Linear {
+
+/*!
+ * \ingroup Linear
+ * \brief The sparsity pattern of a matrix in compressed row storage format.
+ *
+ * The pattern is built in two passes over the same set of entries: In the counting
+ * pass, add() only counts the (possibly duplicate) entries of each row. After
+ * beginFill() has been called, the same entries must be added again, which stores
+ * their column indices. Finally, finalize() sorts the rows and removes duplicate
+ * entries. add() may be called concurrently by multiple threads in both passes.
+ *
+ * Compared to a std::set for each row, this avoids a heap allocation per non-zero
+ * entry.
+ */
+class SparsityPattern
+{
+public:
+    /*!
+     * \brief The column indices of a row of the pattern.
+     */
+    class Row
+    {
+    public:
+        Row(const unsigned* begin, const unsigned* end)
+            : begin_(begin)
+            , end_(end)
+        {}
+
+        const unsigned* begin() const
+        { return begin_; }
+
+        const unsigned* end() const
+        { return end_; }
+
+        size_t size() const
+        { return static_cast<size_t>(end_ - begin_); }
+
+    private:
+        const unsigned* begin_;
+        const unsigned* end_;
+    };
+
+    SparsityPattern()
+        : numRows_(0)
+        , filling_(false)
+    {}
+
+    /*!
+     * \brief Remove all entries and start the counting pass for a pattern with a given
+     *        number of rows.
+     */
+    void init(size_t numRows)
+    {
+        numRows_ = numRows;
+        filling_ = false;
+
+        // std::atomic is neither copyable nor movable, so we cannot resize a vector of
+        // them...
+        rowFill_.reset(new std::atomic<unsigned>[numRows_]);
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx)
+            rowFill_[rowIdx].store(0, std::memory_order_relaxed);
+
+        rowOffsets_.assign(numRows_ + 1, 0);
+        columnIndices_.clear();
+    }
+
+    /*!
+     * \brief Add an entry to the pattern.
+     *
+     * During the counting pass this only reserves space for the entry, in the filling
+     * pass the entry is actually stored. Duplicate entries are allowed.
+     */
+    void add(size_t rowIdx, unsigned colIdx)
+    {
+        assert(rowIdx < numRows_);
+        unsigned pos = rowFill_[rowIdx].fetch_add(1, std::memory_order_relaxed);
+        if (filling_) {
+            assert(rowOffsets_[rowIdx] + pos < rowOffsets_[rowIdx + 1]);
+            columnIndices_[rowOffsets_[rowIdx] + pos] = colIdx;
+        }
+    }
+
+    /*!
+     * \brief Finish the counting pass and start the filling pass.
+     */
+    void beginFill()
+    {
+        assert(!filling_);
+
+        rowOffsets_[0] = 0;
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
+            rowOffsets_[rowIdx + 1] = rowOffsets_[rowIdx] + rowFill_[rowIdx].load(std::memory_order_relaxed);
+            rowFill_[rowIdx].store(0, std::memory_order_relaxed);
+        }
+
+        columnIndices_.resize(rowOffsets_[numRows_]);
+        filling_ = true;
+    }
+
+    /*!
+     * \brief Finish the filling pass.
+     *
+     * This sorts the column indices of each row and removes all duplicates.
+     */
+    void finalize()
+    {
+        assert(filling_);
+
+        // sort the rows and determine the number of unique entries of each of them
+        std::vector<size_t> uniqueSize(numRows_);
+        const long numRows = static_cast<long>(numRows_);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (long rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+            assert(rowFill_[rowIdx].load(std::memory_order_relaxed)
+                   == rowOffsets_[rowIdx + 1] - rowOffsets_[rowIdx]);
+
+            unsigned* rowBegin = columnIndices_.data() + rowOffsets_[rowIdx];
+            unsigned* rowEnd = columnIndices_.data() + rowOffsets_[rowIdx + 1];
+            std::sort(rowBegin, rowEnd);
+            uniqueSize[rowIdx] = static_cast<size_t>(std::unique(rowBegin, rowEnd) - rowBegin);
+        }
+
+        // compact the storage. since the rows only shrink, this can be done in place.
+        size_t newOffset = 0;
+        for (size_t rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
+            size_t oldOffset = rowOffsets_[rowIdx];
+            std::copy(columnIndices_.begin() + oldOffset,
+                      columnIndices_.begin() + oldOffset + uniqueSize[rowIdx],
+                      columnIndices_.begin() + newOffset);
+            rowOffsets_[rowIdx] = newOffset;
+            newOffset += uniqueSize[rowIdx];
+        }
+        rowOffsets_[numRows_] = newOffset;
+        columnIndices_.resize(newOffset);
+        columnIndices_.shrink_to_fit();
+
+        rowFill_.reset();
+        filling_ = false;
+    }
+
+    /*!
+     * \brief Returns true if the filling pass has been started but not yet finalized.
+     */
+    bool filling() const
+    { return filling_; }
+
+    /*!
+     * \brief Return the number of rows of the pattern.
+     */
+    size_t size() const
+    { return numRows_; }
+
+    /*!
+     * \brief Return the total number of non-zero entries of the finalized pattern.
+     */
+    size_t numNonZeros() const
+    { return columnIndices_.size(); }
+
+    /*!
+     * \brief Return the sorted column indices of a row of the finalized pattern.
+     */
+    Row operator[](size_t rowIdx) const
+    {
+        const unsigned* data = columnIndices_.data();
+        return Row(data + rowOffsets_[rowIdx], data + rowOffsets_[rowIdx + 1]);
+    }
+
+private:
+    size_t numRows_;
+    bool filling_;
+
+    std::unique_ptr<std::atomic<unsigned>[]> rowFill_;
+    std::vector<size_t> rowOffsets_;
+    std::vector<unsigned> columnIndices_;
+};
+
+}} // namespace Linear, Opm
+
+#endif
@@ -29,16 +29,19 @@
 
 #if HAVE_SUPERLU
 
-#include <opm/models/linear/istlsparsematrixbackend.hh>
+#include <opm/simulators/linalg/istlsparsematrixadapter.hh>
+#include <opm/simulators/linalg/matrixblock.hh>
 #include <opm/models/utils/parametersystem.hh>
 #include <opm/simulators/linalg/linalgproperties.hh>
 
-#include <opm/material/common/Unused.hpp>
-
 #include <dune/istl/superlu.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/common/version.hh>
 
+#include <cmath>
+#include <iostream>
+#include <memory>
+
 namespace Opm::Properties::TTag {
 struct SuperLULinearSolver {};
 } // namespace Opm::Properties::TTag
@@ -51,6 +54,18 @@ class SuperLUSolve_;
 /*!
  * \ingroup Linear
  * \brief A linear solver backend for the SuperLU sparse matrix library.
+ *
+ * The factorization of the matrix is kept across linear solves: If the matrix was not
+ * changed since the last call to solve(), the cached factors are applied directly. If
+ * the LinearSolverReuseFactorization parameter is set, the factors of an outdated
+ * matrix are used as the preconditioner of an iterative refinement and the matrix is
+ * only factorized again if the refinement does not converge. All cached data is
+ * discarded if the grid changes.
+ *
+ * Note that SuperLU is driven through the Dune::SuperLU adapter, which re-computes the
+ * column ordering and the symbolic factorization for every new factorization even if
+ * the sparsity pattern of the matrix did not change. The symbolic analysis is thus not
+ * reused; only complete numeric factorizations are.
  */
 template <class TypeTag>
 class SuperLUBackend
@@ -58,32 +73,54 @@ class SuperLUBackend
     using Scalar = GetPropType<TypeTag, Properties::Scalar>;
     using Simulator = GetPropType<TypeTag, Properties::Simulator>;
     using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
-    using Matrix = typename SparseMatrixAdapter::block_type;
-
-    static_assert(std::is_same<SparseMatrixAdapter, IstlSparseMatrixAdapter<MatrixBlock>::value,
-                  "The SuperLU linear solver backend requires the IstlSparseMatrixAdapter");
+    using Vector = GetPropType<TypeTag, Properties::GlobalEqVector>;
+    using Matrix = typename SparseMatrixAdapter::IstlMatrix;
+    using Solver = SuperLUSolve_<Scalar, TypeTag, Matrix, Vector>;
 
 public:
-    SuperLUBackend(Simulator& simulator OPM_UNUSED)
+    SuperLUBackend(Simulator& simulator)
+        : simulator_(simulator)
+        , M_(nullptr)
+        , b_(nullptr)
+        , gridSequenceNumber_(-1)
+        , matrixChanged_(true)
     {}
 
     static void registerParameters()
     {
         EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverVerbosity,
                              "The verbosity level of the linear solver");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverReuseFactorization,
+                             "Use the factorization of a previous matrix as the "
+                             "preconditioner of an iterative refinement instead of "
+                             "factorizing each matrix");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, LinearSolverTolerance,
+                             "The reduction of the residual which the iterative "
+                             "refinement must achieve");
+        EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverMaxIterations,
+                             "The maximum number of iterative refinement steps before "
+                             "the matrix is factorized again");
     }
 
     /*!
      * \brief Causes the solve() method to discared the structure of the linear system of
      *        equations the next time it is called.
      *
-     * Since the SuperLU backend does not create any internal matrices, this is a no-op.
+     * This drops the cached factorization of the matrix.
      */
     void eraseMatrix()
-    { }
+    { solver_.reset(); }
+
+    void prepare(const SparseMatrixAdapter&, const Vector&)
+    {
+        // the factorization only stays valid as long as the grid does not change
+        int curSeqNum = simulator_.vanguard().gridSequenceNumber();
+        if (gridSequenceNumber_ == curSeqNum)
+            return;
 
-    void prepare(const SparseMatrixAdapter& M, const Vector& b)
-    { }
+        solver_.reset();
+        gridSequenceNumber_ = curSeqNum;
+    }
 
     void setResidual(const Vector& b)
     { b_ = &b; }
@@ -92,42 +129,139 @@ public:
     { b = *b_; }
 
     void setMatrix(const SparseMatrixAdapter& M)
-    { M_ = &M; }
+    {
+        M_ = &M.istlMatrix();
+        matrixChanged_ = true;
+    }
 
     bool solve(Vector& x)
-    { return SuperLUSolve_<Scalar, TypeTag, Matrix, Vector>::solve_(*M_, x, *b_); }
+    {
+        if (!solver_.isFactorized() ||
+            (matrixChanged_ && !EWOMS_GET_PARAM(TypeTag, bool, LinearSolverReuseFactorization)))
+            factorize_();
+
+        if (!matrixChanged_)
+            return solver_.apply(x, *b_) && isFinite_(x);
+
+        // the factors belong to an older matrix. try to get away with an iterative
+        // refinement before paying for a new factorization
+        if (refine_(x))
+            return true;
+
+        factorize_();
+        return solver_.apply(x, *b_) && isFinite_(x);
+    }
 
 private:
+    void factorize_()
+    {
+        int verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
+        solver_.factorize(*M_, verbosity);
+        matrixChanged_ = false;
+    }
+
+    bool refine_(Vector& x)
+    {
+        const Matrix& A = *M_;
+        const Vector& b = *b_;
+
+        Scalar tolerance = EWOMS_GET_PARAM(TypeTag, Scalar, LinearSolverTolerance);
+        int maxIterations = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIterations);
+        int verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
+
+        x = 0.0;
+        Scalar bNorm = b.two_norm();
+        if (bNorm == 0.0)
+            return true;
+
+        residual_ = b;
+        correction_.resize(x.size());
+        for (int iterIdx = 0; iterIdx < maxIterations; ++iterIdx) {
+            if (!solver_.apply(correction_, residual_))
+                return false;
+            x += correction_;
+
+            residual_ = b;
+            A.mmv(x, residual_);
+            Scalar reduction = residual_.two_norm()/bNorm;
+            if (verbosity > 1)
+                std::cout << "SuperLU refinement step " << iterIdx
+                          << ": residual reduction " << reduction << "\n";
+
+            if (!std::isfinite(reduction))
+                return false;
+            if (reduction <= tolerance)
+                return true;
+        }
+
+        return false;
+    }
+
+    // make sure that the result only contains finite values.
+    static bool isFinite_(const Vector& x)
+    {
+        Scalar tmp = 0;
+        for (unsigned i = 0; i < x.size(); ++i) {
+            const auto& xi = x[i];
+            for (unsigned j = 0; j < Vector::block_type::dimension; ++j)
+                tmp += xi[j];
+        }
+        return std::isfinite(tmp);
+    }
+
+    const Simulator& simulator_;
     const Matrix* M_;
-    Vector* b_;
+    const Vector* b_;
+
+    Solver solver_;
+    Vector residual_;
+    Vector correction_;
+
+    int gridSequenceNumber_;
+    bool matrixChanged_;
 };
 
+/*!
+ * \brief Holds the factorization of a matrix computed by SuperLU.
+ */
 template <class Scalar, class TypeTag, class Matrix, class Vector>
 class SuperLUSolve_
 {
 public:
-    static bool solve_(const Matrix& A, Vector& x, const Vector& b)
+    bool isFactorized() const
+    { return static_cast<bool>(superLu_); }
+
+    void reset()
+    { superLu_.reset(); }
+
+    void factorize(const Matrix& A, int verbosity)
     {
-        Vector bTmp(b);
+        // note that setMatrix() does the same work as creating a new object, i.e., the
+        // column ordering and the symbolic factorization of the old matrix are not
+        // reused. we only keep the object around to avoid re-allocating it.
+        //
+        // SuperLU keeps pointers to the vectors of the first apply() if it is asked to
+        // reuse them. we solve for several different vectors, so we must not let it.
+        if (superLu_)
+            superLu_->setMatrix(A);
+        else
+            superLu_.reset(new Dune::SuperLU<Matrix>(A, verbosity > 0, /*reuseVector=*/false));
+    }
 
-        int verbosity = EWOMS_GET_PARAM(TypeTag, int, LinearSolverVerbosity);
-        Dune::InverseOperatorResult result;
-        Dune::SuperLU<Matrix> solver(A, verbosity > 0);
-        solver.apply(x, bTmp, result);
-
-        if (result.converged) {
-            // make sure that the result only contains finite values.
-            Scalar tmp = 0;
-            for (unsigned i = 0; i < x.size(); ++i) {
-                const auto& xi = x[i];
-                for (unsigned j = 0; j < Vector::block_type::dimension; ++j)
-                    tmp += xi[j];
-            }
-            result.converged = std::isfinite(tmp);
-        }
+    bool apply(Vector& x, const Vector& b)
+    {
+        // SuperLU overwrites the right hand side, so we solve for a copy. the buffer for
+        // this copy is kept around to avoid allocating it for each solve.
+        bTmp_ = b;
 
+        Dune::InverseOperatorResult result;
+        superLu_->apply(x, bTmp_, result);
         return result.converged;
     }
+
+private:
+    std::unique_ptr<Dune::SuperLU<Matrix> > superLu_;
+    Vector bTmp_;
 };
 
 // the following is required to make the SuperLU adapter of dune-istl happy with
@@ -138,32 +272,44 @@ public:
 template <class TypeTag, class Matrix, class Vector>
 class SuperLUSolve_<__float128, TypeTag, Matrix, Vector>
 {
+    static const int numEq = getPropValue<TypeTag, Properties::NumEq>();
+    using DoubleEqVector = Dune::FieldVector<double, numEq>;
+    using DoubleEqMatrix = Dune::FieldMatrix<double, numEq, numEq>;
+    using DoubleVector = Dune::BlockVector<DoubleEqVector>;
+    using DoubleMatrix = Dune::BCRSMatrix<DoubleEqMatrix>;
+
 public:
-    static bool solve_(const Matrix& A,
-                       Vector& x,
-                       const Vector& b)
+    bool isFactorized() const
+    { return doubleSolver_.isFactorized(); }
+
+    void reset()
+    { doubleSolver_.reset(); }
+
+    void factorize(const Matrix& A, int verbosity)
     {
-        static const int numEq = getPropValue<TypeTag, Properties::NumEq>();
-        using DoubleEqVector = Dune::FieldVector<double, numEq>;
-        using DoubleEqMatrix = Dune::FieldMatrix<double, numEq, numEq>;
-        using DoubleVector = Dune::BlockVector<DoubleEqVector>;
-        using DoubleMatrix = Dune::BCRSMatrix<DoubleEqMatrix>;
+        // copy the matrix into the double precision data structure
+        DoubleMatrix ADouble(A);
+        doubleSolver_.factorize(ADouble, verbosity);
+    }
 
+    bool apply(Vector& x, const Vector& b)
+    {
         // copy the inputs into the double precision data structures
-        DoubleVector bDouble(b);
-        DoubleVector xDouble(x);
-        DoubleMatrix ADouble(A);
+        bDouble_ = b;
+        xDouble_ = x;
 
-        bool res =
-            SuperLUSolve_<double, TypeTag, Matrix, Vector>::solve_(ADouble,
-                                                                   xDouble,
-                                                                   bDouble);
+        bool res = doubleSolver_.apply(xDouble_, bDouble_);
 
         // copy the result back into the quadruple precision vector.
-        x = xDouble;
+        x = xDouble_;
 
         return res;
     }
+
+private:
+    SuperLUSolve_<double, TypeTag, DoubleMatrix, DoubleVector> doubleSolver_;
+    DoubleVector bDouble_;
+    DoubleVector xDouble_;
 };
 #endif
 
@@ -172,10 +318,28 @@ public:
 
 namespace Opm::Properties {
 
+//! Set the type of a global jacobian matrix for the SuperLU backend
+template<class TypeTag>
+struct SparseMatrixAdapter<TypeTag, TTag::SuperLULinearSolver>
+{
+private:
+    using Scalar = GetPropType<TypeTag, Properties::Scalar>;
+    enum { numEq = getPropValue<TypeTag, Properties::NumEq>() };
+    using Block = Opm::MatrixBlock<Scalar, numEq, numEq>;
+
+public:
+    using type = typename Opm::Linear::IstlSparseMatrixAdapter<Block>;
+};
+
 template<class TypeTag>
 struct LinearSolverVerbosity<TypeTag, TTag::SuperLULinearSolver> { static constexpr int value = 0; };
 template<class TypeTag>
 struct LinearSolverBackend<TypeTag, TTag::SuperLULinearSolver> { using type = Opm::Linear::SuperLUBackend<TypeTag>; };
+template<class TypeTag>
+struct LinearSolverReuseFactorization<TypeTag, TTag::SuperLULinearSolver> { static constexpr bool value = false; };
+//! the maximum number of iterative refinement steps
+template<class TypeTag>
+struct LinearSolverMaxIterations<TypeTag, TTag::SuperLULinearSolver> { static constexpr int value = 10; };
 
 } // namespace Opm::Properties
 
@@ -0,0 +1,62 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Three-dimensional two-phase test for the immiscible model which uses the
+ *        vertex-centered finite volume discretization and finite differences
+ *
+ * On hexahedra, opposite corners of an element do not affect the residual of a common
+ * vertex, so this test covers deflecting several degrees of freedom of an element at
+ * once if NumericDifferenceColoredColumns is enabled.
+ */
+#include "config.h"
+
+#include <opm/models/utils/start.hh>
+#include <opm/models/immiscible/immisciblemodel.hh>
+#include "problems/lensproblem.hh"
+
+#include <dune/grid/yaspgrid.hh>
+
+namespace Opm::Properties {
+
+// Create new type tags
+namespace TTag {
+struct LensProblemVcfvFd3d { using InheritsFrom = std::tuple<LensBaseProblem, ImmiscibleTwoPhaseModel>; };
+} // end namespace TTag
+
+// use the finite difference method for this simulator
+template<class TypeTag>
+struct LocalLinearizerSplice<TypeTag, TTag::LensProblemVcfvFd3d> { using type = TTag::FiniteDifferenceLocalLinearizer; };
+
+// use a three-dimensional grid of hexahedra
+template<class TypeTag>
+struct Grid<TypeTag, TTag::LensProblemVcfvFd3d> { using type = Dune::YaspGrid<3>; };
+
+} // namespace Opm::Properties
+
+int main(int argc, char **argv)
+{
+    using ProblemTypeTag = Opm::Properties::TTag::LensProblemVcfvFd3d;
+    return Opm::start<ProblemTypeTag>(argc, argv);
+}